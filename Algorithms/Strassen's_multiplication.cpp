@@ -5,6 +5,39 @@
 #include <ctime>
 #include <iomanip>
 #include <stdexcept>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <cstring>
+#include <type_traits>
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define STRASSEN_X86_KERNELS 1
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define STRASSEN_HAS_MMAP 1
+#endif
 
 /**
  * Strassen Matrix Multiplication Algorithm Implementation
@@ -13,360 +46,2555 @@
  * It reduces the number of recursive multiplications from 8 to 7.
  * * Time Complexity: O(n^log₂7) ≈ O(n^2.807)
  * Space Complexity: O(log n) for recursion stack + O(n²) for temporary matrices
+ * * Matrices are stored contiguously in row-major order. The recursion works on
+ * stride-aware views, so splitting a matrix into quadrants never copies data.
+ * Any shape is handled without padding: long dimensions are halved until the
+ * product is near-cubic, and odd sizes are split with dynamic peeling.
+ * All temporaries come from one workspace arena sized before the multiply starts.
+ * * The engine is templated on the element type: int32 (computed with int64
+ * accumulators so large products cannot overflow), int64, float, double and
+ * integers modulo a prime. Select one in the driver with --type.
+ * * The leaf kernel is a packed, register-tiled GEMM with per-type AVX2/AVX-512
+ * micro-kernels chosen at runtime from the CPU features, falling back to portable scalar code.
+ * * With --threads N the top recursion levels run M1..M7 as tasks on a
+ * work-stealing thread pool. Build with: g++ -std=c++17 -O2 -pthread
+ * * The crossover to the leaf kernel is tuned per machine (menu option 4) and
+ * stored in strassen_tuning.cfg, which is loaded at startup.
+ * * Matrices too large for memory can be multiplied out of core (menu option 5):
+ * they live in binary tiled files that are memory-mapped and streamed through
+ * the leaf kernel a few tiles at a time.
+ * * batchedMultiply runs many independent small products (e.g. millions of 4 x 4 to
+ * 32 x 32 pairs) stored back to back in one buffer, with compile-time-size kernels.
+ * * Menu option 7 multiplies matrices stored in files: a raw binary format (STRMATX1
+ * header plus row-major data) or text ("rows cols" then the elements), loaded through
+ * mmap and a hand-rolled number scanner, with a matching writer for the result.
+ * * Menu option 3 (or --bench) benchmarks Strassen against the standard multiply
+ * with warmups, repeated wall-clock trials, median/p95 and GFLOP/s, and can export CSV/JSON.
+ * * --schedule winograd switches sequential levels to the Strassen-Winograd form
+ * (15 block additions instead of 18, two scratch blocks instead of three).
  * * @author Hacktoberfest2025 Contributor
  */
 
-// Define a matrix type alias for cleaner code (vector of vectors of ints)
-using Matrix = std::vector<std::vector<int>>;
+// Threshold below which to use standard multiplication, used until a machine has been tuned
+const int DEFAULT_THRESHOLD = 64;
 
-// Threshold below which to use standard multiplication
-const int THRESHOLD = 64;
+// Where autotuned settings are saved and loaded from by default
+const char* const DEFAULT_TUNING_FILE = "strassen_tuning.cfg";
+
+// --- Element Types ---
+
+/**
+ * Integer modulo a prime P < 2^31, for exact counting workloads.
+ * Values are kept fully reduced in [0, P).
+ */
+template <uint32_t P>
+struct ModInt {
+    static_assert(P > 1 && P < (1u << 31), "modulus must fit in 31 bits");
+    static const uint32_t modulus = P;
+
+    uint32_t value;
+
+    ModInt() : value(0) {}
+    ModInt(long long v) {
+        v %= static_cast<long long>(P);
+        value = static_cast<uint32_t>(v < 0 ? v + P : v);
+    }
+
+    ModInt& operator+=(ModInt other) {
+        value += other.value;
+        if (value >= P) value -= P;
+        return *this;
+    }
+    ModInt& operator-=(ModInt other) {
+        value = value >= other.value ? value - other.value : value + P - other.value;
+        return *this;
+    }
+    ModInt& operator*=(ModInt other) {
+        value = static_cast<uint32_t>(static_cast<uint64_t>(value) * other.value % P);
+        return *this;
+    }
+
+    friend ModInt operator+(ModInt a, ModInt b) { return a += b; }
+    friend ModInt operator-(ModInt a, ModInt b) { return a -= b; }
+    friend ModInt operator*(ModInt a, ModInt b) { return a *= b; }
+    friend bool operator==(ModInt a, ModInt b) { return a.value == b.value; }
+    friend bool operator!=(ModInt a, ModInt b) { return a.value != b.value; }
+
+    friend std::ostream& operator<<(std::ostream& out, ModInt x) { return out << x.value; }
+    friend std::istream& operator>>(std::istream& in, ModInt& x) {
+        long long v;
+        if (in >> v) x = ModInt(v);
+        return in;
+    }
+};
+
+// Default modulus for the "mod" element type
+using ModP = ModInt<998244353>;
+
+template <typename T> struct IsModInt : std::false_type {};
+template <uint32_t P> struct IsModInt<ModInt<P>> : std::true_type {};
+
+/**
+ * Per-element-type facts the engine needs. Acc is the type the recursion and
+ * leaf kernel compute in; int32 inputs are widened once so that Strassen's
+ * operand sums and the dot products cannot overflow.
+ */
+template <typename T>
+struct ElementTraits {
+    using Acc = T;
+};
+
+template <>
+struct ElementTraits<int32_t> {
+    using Acc = int64_t;
+};
+
+template <typename T>
+using Accumulator = typename ElementTraits<T>::Acc;
+
+template <typename T> const char* elementTypeName();
+template <> const char* elementTypeName<int32_t>() { return "int32 (int64 accumulators)"; }
+template <> const char* elementTypeName<int64_t>() { return "int64"; }
+template <> const char* elementTypeName<float>() { return "float"; }
+template <> const char* elementTypeName<double>() { return "double"; }
+template <> const char* elementTypeName<ModP>() { return "mod 998244353"; }
+
+// Stable per-type tag written into binary matrix files
+template <typename T> uint32_t elementTypeCode();
+template <> uint32_t elementTypeCode<int32_t>() { return 1; }
+template <> uint32_t elementTypeCode<int64_t>() { return 2; }
+template <> uint32_t elementTypeCode<float>() { return 3; }
+template <> uint32_t elementTypeCode<double>() { return 4; }
+template <> uint32_t elementTypeCode<ModP>() { return 5; }
+
+// --- Matrix Storage ---
+
+/**
+ * Mutable, non-owning window into row-major storage.
+ * Element (i, j) lives at data[i * stride + j], so a quadrant of a larger
+ * matrix is just a view with an offset pointer and the parent's stride.
+ */
+template <typename T>
+struct MatrixView {
+    T* data;
+    int rows;
+    int cols;
+    int stride;
+
+    T& operator()(int i, int j) const { return data[static_cast<size_t>(i) * stride + j]; }
+    T* row(int i) const { return data + static_cast<size_t>(i) * stride; }
+
+    MatrixView block(int rowStart, int colStart, int numRows, int numCols) const {
+        return {row(rowStart) + colStart, numRows, numCols, stride};
+    }
+};
+
+/**
+ * Read-only counterpart of MatrixView. A MatrixView converts to it implicitly.
+ */
+template <typename T>
+struct ConstMatrixView {
+    const T* data;
+    int rows;
+    int cols;
+    int stride;
+
+    ConstMatrixView(const T* data, int rows, int cols, int stride)
+        : data(data), rows(rows), cols(cols), stride(stride) {}
+    ConstMatrixView(const MatrixView<T>& v) : data(v.data), rows(v.rows), cols(v.cols), stride(v.stride) {}
+
+    const T& operator()(int i, int j) const { return data[static_cast<size_t>(i) * stride + j]; }
+    const T* row(int i) const { return data + static_cast<size_t>(i) * stride; }
+
+    ConstMatrixView block(int rowStart, int colStart, int numRows, int numCols) const {
+        return {row(rowStart) + colStart, numRows, numCols, stride};
+    }
+};
+
+template <typename T>
+struct Identity {
+    using type = T;
+};
+
+/**
+ * Read-only view parameter whose element type is taken from the output view,
+ * so callers can pass a MatrixView<T> where a ConstMatrixView<T> is expected.
+ */
+template <typename T>
+using InputView = ConstMatrixView<typename Identity<T>::type>;
+
+/**
+ * Owning dense matrix: one heap allocation holding rows * cols elements in row-major order.
+ */
+template <typename T>
+class Matrix {
+public:
+    Matrix() : rows_(0), cols_(0) {}
+    /**
+     * @throws std::invalid_argument if a dimension is negative
+     */
+    Matrix(int rows, int cols, T value = T())
+        : rows_(rows), cols_(cols), data_(checkedSize(rows, cols), value) {}
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    bool empty() const { return data_.empty(); }
+
+    T& operator()(int i, int j) { return data_[static_cast<size_t>(i) * cols_ + j]; }
+    const T& operator()(int i, int j) const { return data_[static_cast<size_t>(i) * cols_ + j]; }
+
+    T* data() { return data_.data(); }
+    const T* data() const { return data_.data(); }
+
+    MatrixView<T> view() { return {data_.data(), rows_, cols_, cols_}; }
+    ConstMatrixView<T> view() const { return {data_.data(), rows_, cols_, cols_}; }
+
+    bool operator==(const Matrix& other) const {
+        return rows_ == other.rows_ && cols_ == other.cols_ && data_ == other.data_;
+    }
+
+private:
+    static size_t checkedSize(int rows, int cols) {
+        if (rows < 0 || cols < 0) {
+            throw std::invalid_argument("Invalid matrix shape: dimensions must not be negative.");
+        }
+        return static_cast<size_t>(rows) * cols;
+    }
+
+    int rows_;
+    int cols_;
+    std::vector<T> data_;
+};
+
+/**
+ * Element-wise conversion, used to widen int32 inputs to their accumulator type
+ */
+template <typename To, typename From>
+Matrix<To> convertMatrix(const Matrix<From>& matrix) {
+    Matrix<To> result(matrix.rows(), matrix.cols());
+    std::transform(matrix.data(), matrix.data() + static_cast<size_t>(matrix.rows()) * matrix.cols(),
+                   result.data(), [](const From& x) { return static_cast<To>(x); });
+    return result;
+}
+
+// --- Workspace Arena ---
+
+// Arena blocks are padded to a multiple of this many elements so each block starts on a 16-element
+// boundary of the buffer; row strides are not padded, so this does not make rows cache-line aligned
+const size_t ARENA_ALIGN = 16;
+
+size_t arenaBlockSize(int rows, int cols) {
+    size_t n = static_cast<size_t>(rows) * cols;
+    return (n + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+}
+
+/**
+ * Bump-pointer arena for recursion temporaries.
+ * The whole buffer is allocated once; each recursion level takes a mark on entry,
+ * carves its scratch blocks, and releases back to the mark on return.
+ */
+template <typename T>
+class Workspace {
+public:
+    explicit Workspace(size_t elements)
+        : storage_(elements), base_(storage_.data()), size_(elements), top_(0), peak_(0) {}
+
+    Workspace(Workspace&&) = default;
+    Workspace(const Workspace&) = delete;
+    Workspace& operator=(const Workspace&) = delete;
+
+    MatrixView<T> allocate(int rows, int cols) {
+        return {take(arenaBlockSize(rows, cols)), rows, cols, cols};
+    }
+
+    /**
+     * Hand a slice of this arena to a parallel task as its own arena.
+     * The slice stays reserved until the parent releases past it.
+     */
+    Workspace split(size_t elements) {
+        return Workspace(take(elements), elements);
+    }
+
+    size_t mark() const { return top_; }
+    void release(size_t mark) { top_ = mark; }
+
+    size_t capacity() const { return size_; }
+    size_t peak() const { return peak_; }
+
+private:
+    Workspace(T* base, size_t size) : base_(base), size_(size), top_(0), peak_(0) {}
+
+    T* take(size_t elements) {
+        if (top_ + elements > size_) {
+            throw std::logic_error("Strassen workspace exhausted: arena was sized too small.");
+        }
+        T* block = base_ + top_;
+        top_ += elements;
+        peak_ = std::max(peak_, top_);
+        return block;
+    }
+
+    std::vector<T> storage_;  // empty for arenas split from a parent
+    T* base_;
+    size_t size_;
+    size_t top_;
+    size_t peak_;
+};
+
+// --- Work-Stealing Thread Pool ---
+
+/**
+ * Fixed-size pool where every worker owns a deque. Workers pop their own
+ * newest task first and steal the oldest task from others when idle, so
+ * recursive task trees stay cache-local while still spreading across cores.
+ * Threads outside the pool submit through a shared injection queue.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(int workers) : queued_(0), stop_(false) {
+        for (int i = 0; i <= workers; i++) {
+            queues_.emplace_back(new WorkQueue());
+        }
+        for (int i = 0; i < workers; i++) {
+            threads_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& t : threads_) {
+            t.join();
+        }
+    }
+
+    int workers() const { return static_cast<int>(threads_.size()); }
+
+    void submit(Task task) {
+        int index = (currentPool() == this) ? currentIndex() : workers();
+        {
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            queued_++;
+        }
+        wake_.notify_one();
+    }
+
+    /**
+     * Run one queued task on the calling thread. Returns false if nothing was available.
+     */
+    bool runPendingTask() {
+        int self = (currentPool() == this) ? currentIndex() : workers();
+        Task task;
+        if (!takeTask(self, task)) {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    static ThreadPool*& currentPool() {
+        thread_local ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    static int& currentIndex() {
+        thread_local int index = -1;
+        return index;
+    }
+
+    bool takeTask(int self, Task& task) {
+        // Own queue, newest first
+        {
+            WorkQueue& own = *queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                queued_--;
+                return true;
+            }
+        }
+        // Steal the oldest task from anyone else, injection queue included
+        int count = static_cast<int>(queues_.size());
+        for (int offset = 1; offset < count; offset++) {
+            WorkQueue& victim = *queues_[(self + offset) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued_--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int index) {
+        currentPool() = this;
+        currentIndex() = index;
+
+        while (true) {
+            Task task;
+            if (takeTask(index, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this] { return stop_ || queued_ > 0; });
+            if (stop_ && queued_ == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;  // one per worker plus the injection queue
+    std::vector<std::thread> threads_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<int> queued_;
+    bool stop_;
+};
+
+/**
+ * A batch of tasks that can be waited on. The waiting thread keeps executing
+ * queued tasks instead of blocking, so nested groups cannot deadlock the pool.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool_(pool), pending_(0) {}
+
+    void run(std::function<void()> task) {
+        pending_++;
+        pool_.submit([this, task] {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+            pending_--;
+        });
+    }
+
+    void wait() {
+        while (pending_ > 0) {
+            if (!pool_.runPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    ThreadPool& pool_;
+    std::atomic<int> pending_;
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+/**
+ * Process-wide pool reused across multiplies. The calling thread also works
+ * while it waits, so a run with N threads keeps N - 1 pool workers.
+ * Not safe to resize from several threads at once.
+ */
+ThreadPool* sharedPool(int threads) {
+    static std::unique_ptr<ThreadPool> pool;
+    if (threads <= 1) {
+        return nullptr;
+    }
+    if (!pool || pool->workers() != threads - 1) {
+        pool.reset();
+        pool.reset(new ThreadPool(threads - 1));
+    }
+    return pool.get();
+}
+
+/**
+ * Order of operations inside a sequential Strassen level
+ */
+enum class StrassenSchedule {
+    Classic,   // original M1..M7 formulas: 18 block additions, three scratch blocks
+    Winograd   // Strassen-Winograd variant: 15 block additions, two scratch blocks
+};
+
+/**
+ * Tuning knobs for strassenMultiply
+ */
+struct StrassenOptions {
+    int threads = 1;        // total threads including the caller (1 = sequential)
+    int parallelDepth = 2;  // recursion levels whose seven products run as tasks
+    int threshold = 0;      // leaf crossover; 0 = use the tuned value
+    StrassenSchedule schedule = StrassenSchedule::Classic;
+};
+
+const char* scheduleName(StrassenSchedule schedule) {
+    return schedule == StrassenSchedule::Winograd ? "winograd" : "classic";
+}
+
+bool parseSchedule(const std::string& name, StrassenSchedule& schedule) {
+    if (name == "classic") schedule = StrassenSchedule::Classic;
+    else if (name == "winograd") schedule = StrassenSchedule::Winograd;
+    else return false;
+    return true;
+}
+
+/**
+ * Crossover loaded from the tuning file (DEFAULT_THRESHOLD if the machine was never tuned)
+ */
+int& tunedThreshold() {
+    static int threshold = DEFAULT_THRESHOLD;
+    return threshold;
+}
+
+/**
+ * Threshold a multiply will actually use: an explicit override wins over the tuned value
+ */
+int effectiveThreshold(const StrassenOptions& options) {
+    return options.threshold > 0 ? options.threshold : tunedThreshold();
+}
+
+/**
+ * Per-multiply state shared by every recursion level
+ */
+struct StrassenContext {
+    int threshold;
+    StrassenSchedule schedule;
+    ThreadPool* pool;  // null when running sequentially
+};
+
+// --- Leaf Kernel ---
+
+// Cache blocking: a KERNEL_MC x KERNEL_KC panel of A stays in L2 while
+// a KERNEL_KC x KERNEL_NC panel of B streams through
+const int KERNEL_MC = 64;
+const int KERNEL_KC = 256;
+const int KERNEL_NC = 2048;
+
+/**
+ * Micro-tile of C computed in registers: MR rows by NR columns. NR is one
+ * AVX-512 register (or two AVX2 registers) of the element type.
+ */
+template <typename T>
+struct KernelShape {
+    static const int MR = 4;
+    static const int NR = 8;
+};
+
+template <>
+struct KernelShape<float> {
+    static const int MR = 4;
+    static const int NR = 16;
+};
+
+/**
+ * Micro-kernel signature: C[MR x NR] += packedA[kc x MR] * packedB[kc x NR].
+ * packedA holds MR values per k step, packedB holds NR values per k step.
+ */
+template <typename T>
+using MicroKernel = void (*)(int kc, const T* packedA, const T* packedB, T* C, int ldc);
+
+/**
+ * Portable micro-kernel; fixed trip counts let the compiler unroll and vectorize it.
+ */
+template <typename T>
+void microKernelScalar(int kc, const T* packedA, const T* packedB, T* C, int ldc) {
+    const int MR = KernelShape<T>::MR;
+    const int NR = KernelShape<T>::NR;
+    T acc[MR][NR] = {};
+
+    for (int k = 0; k < kc; k++) {
+        const T* a = packedA + k * MR;
+        const T* b = packedB + k * NR;
+        for (int r = 0; r < MR; r++) {
+            for (int c = 0; c < NR; c++) {
+                acc[r][c] += a[r] * b[c];
+            }
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        for (int c = 0; c < NR; c++) {
+            C[r * ldc + c] += acc[r][c];
+        }
+    }
+}
+
+/**
+ * Modular micro-kernel with lazy reduction: products are summed in uint64 and
+ * only reduced mod P once per tile. Subtracting a multiple of P^2 whenever the
+ * running sum crosses 2^63 keeps it from wrapping without changing it mod P.
+ */
+template <uint32_t P>
+void microKernelModular(int kc, const ModInt<P>* packedA, const ModInt<P>* packedB, ModInt<P>* C, int ldc) {
+    const int MR = KernelShape<ModInt<P>>::MR;
+    const int NR = KernelShape<ModInt<P>>::NR;
+    const uint64_t square = static_cast<uint64_t>(P) * P;
+    const uint64_t fold = ((uint64_t(1) << 63) / square) * square;
+    uint64_t acc[MR][NR] = {};
+
+    for (int k = 0; k < kc; k++) {
+        const ModInt<P>* a = packedA + k * MR;
+        const ModInt<P>* b = packedB + k * NR;
+        for (int r = 0; r < MR; r++) {
+            uint64_t ar = a[r].value;
+            for (int c = 0; c < NR; c++) {
+                uint64_t sum = acc[r][c] + ar * b[c].value;
+                acc[r][c] = sum >= fold ? sum - fold : sum;
+            }
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        for (int c = 0; c < NR; c++) {
+            C[r * ldc + c] += ModInt<P>(static_cast<long long>(acc[r][c] % P));
+        }
+    }
+}
+
+#ifdef STRASSEN_X86_KERNELS
+/**
+ * AVX-512DQ int64 micro-kernel: one zmm of 8 int64 per C row.
+ */
+__attribute__((target("avx512f,avx512dq")))
+void microKernelInt64Avx512(int kc, const int64_t* packedA, const int64_t* packedB, int64_t* C, int ldc) {
+    const int MR = KernelShape<int64_t>::MR;
+    const int NR = KernelShape<int64_t>::NR;
+    __m512i acc[MR];
+    for (int r = 0; r < MR; r++) {
+        acc[r] = _mm512_setzero_si512();
+    }
+
+    for (int k = 0; k < kc; k++) {
+        const int64_t* a = packedA + k * MR;
+        __m512i b = _mm512_loadu_si512(packedB + k * NR);
+        for (int r = 0; r < MR; r++) {
+            acc[r] = _mm512_add_epi64(acc[r], _mm512_mullo_epi64(_mm512_set1_epi64(a[r]), b));
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        int64_t* c = C + r * ldc;
+        _mm512_storeu_si512(c, _mm512_add_epi64(_mm512_loadu_si512(c), acc[r]));
+    }
+}
+
+/**
+ * AVX2+FMA float micro-kernel: each C row of 16 floats lives in two ymm accumulators.
+ */
+__attribute__((target("avx2,fma")))
+void microKernelFloatAvx2(int kc, const float* packedA, const float* packedB, float* C, int ldc) {
+    const int MR = KernelShape<float>::MR;
+    const int NR = KernelShape<float>::NR;
+    __m256 acc[MR][2];
+    for (int r = 0; r < MR; r++) {
+        acc[r][0] = _mm256_setzero_ps();
+        acc[r][1] = _mm256_setzero_ps();
+    }
+
+    for (int k = 0; k < kc; k++) {
+        const float* a = packedA + k * MR;
+        __m256 b0 = _mm256_loadu_ps(packedB + k * NR);
+        __m256 b1 = _mm256_loadu_ps(packedB + k * NR + 8);
+        for (int r = 0; r < MR; r++) {
+            __m256 ar = _mm256_broadcast_ss(a + r);
+            acc[r][0] = _mm256_fmadd_ps(ar, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_ps(ar, b1, acc[r][1]);
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        float* c = C + r * ldc;
+        _mm256_storeu_ps(c, _mm256_add_ps(_mm256_loadu_ps(c), acc[r][0]));
+        _mm256_storeu_ps(c + 8, _mm256_add_ps(_mm256_loadu_ps(c + 8), acc[r][1]));
+    }
+}
+
+/**
+ * AVX-512 float micro-kernel: each C row of 16 floats fits in a single zmm accumulator.
+ */
+__attribute__((target("avx512f")))
+void microKernelFloatAvx512(int kc, const float* packedA, const float* packedB, float* C, int ldc) {
+    const int MR = KernelShape<float>::MR;
+    const int NR = KernelShape<float>::NR;
+    __m512 acc[MR];
+    for (int r = 0; r < MR; r++) {
+        acc[r] = _mm512_setzero_ps();
+    }
+
+    for (int k = 0; k < kc; k++) {
+        const float* a = packedA + k * MR;
+        __m512 b = _mm512_loadu_ps(packedB + k * NR);
+        for (int r = 0; r < MR; r++) {
+            acc[r] = _mm512_fmadd_ps(_mm512_set1_ps(a[r]), b, acc[r]);
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        float* c = C + r * ldc;
+        _mm512_storeu_ps(c, _mm512_add_ps(_mm512_loadu_ps(c), acc[r]));
+    }
+}
+
+/**
+ * AVX2+FMA double micro-kernel: each C row of 8 doubles lives in two ymm accumulators.
+ */
+__attribute__((target("avx2,fma")))
+void microKernelDoubleAvx2(int kc, const double* packedA, const double* packedB, double* C, int ldc) {
+    const int MR = KernelShape<double>::MR;
+    const int NR = KernelShape<double>::NR;
+    __m256d acc[MR][2];
+    for (int r = 0; r < MR; r++) {
+        acc[r][0] = _mm256_setzero_pd();
+        acc[r][1] = _mm256_setzero_pd();
+    }
+
+    for (int k = 0; k < kc; k++) {
+        const double* a = packedA + k * MR;
+        __m256d b0 = _mm256_loadu_pd(packedB + k * NR);
+        __m256d b1 = _mm256_loadu_pd(packedB + k * NR + 4);
+        for (int r = 0; r < MR; r++) {
+            __m256d ar = _mm256_broadcast_sd(a + r);
+            acc[r][0] = _mm256_fmadd_pd(ar, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_pd(ar, b1, acc[r][1]);
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        double* c = C + r * ldc;
+        _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), acc[r][0]));
+        _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), acc[r][1]));
+    }
+}
+
+/**
+ * AVX-512 double micro-kernel: each C row of 8 doubles fits in a single zmm accumulator.
+ */
+__attribute__((target("avx512f")))
+void microKernelDoubleAvx512(int kc, const double* packedA, const double* packedB, double* C, int ldc) {
+    const int MR = KernelShape<double>::MR;
+    const int NR = KernelShape<double>::NR;
+    __m512d acc[MR];
+    for (int r = 0; r < MR; r++) {
+        acc[r] = _mm512_setzero_pd();
+    }
+
+    for (int k = 0; k < kc; k++) {
+        const double* a = packedA + k * MR;
+        __m512d b = _mm512_loadu_pd(packedB + k * NR);
+        for (int r = 0; r < MR; r++) {
+            acc[r] = _mm512_fmadd_pd(_mm512_set1_pd(a[r]), b, acc[r]);
+        }
+    }
+
+    for (int r = 0; r < MR; r++) {
+        double* c = C + r * ldc;
+        _mm512_storeu_pd(c, _mm512_add_pd(_mm512_loadu_pd(c), acc[r]));
+    }
+}
+#endif
+
+template <typename T>
+struct LeafKernel {
+    MicroKernel<T> run;
+    const char* name;
+};
+
+/**
+ * Picks the micro-kernel for an element type from the running CPU's features.
+ * Types without a SIMD path use the scalar kernel.
+ */
+template <typename T>
+struct KernelSelector {
+    static LeafKernel<T> select() { return {microKernelScalar<T>, "scalar"}; }
+};
+
+template <uint32_t P>
+struct KernelSelector<ModInt<P>> {
+    static LeafKernel<ModInt<P>> select() { return {microKernelModular<P>, "scalar (lazy mod)"}; }
+};
+
+template <>
+struct KernelSelector<int64_t> {
+    static LeafKernel<int64_t> select() {
+#ifdef STRASSEN_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+            return {microKernelInt64Avx512, "avx512dq"};
+        }
+#endif
+        // AVX2 has no 64-bit multiply, so the compiler-vectorized scalar kernel is used
+        return {microKernelScalar<int64_t>, "scalar"};
+    }
+};
+
+template <>
+struct KernelSelector<float> {
+    static LeafKernel<float> select() {
+#ifdef STRASSEN_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return {microKernelFloatAvx512, "avx512"};
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return {microKernelFloatAvx2, "avx2+fma"};
+        }
+#endif
+        return {microKernelScalar<float>, "scalar"};
+    }
+};
+
+template <>
+struct KernelSelector<double> {
+    static LeafKernel<double> select() {
+#ifdef STRASSEN_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return {microKernelDoubleAvx512, "avx512"};
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return {microKernelDoubleAvx2, "avx2+fma"};
+        }
+#endif
+        return {microKernelScalar<double>, "scalar"};
+    }
+};
+
+/**
+ * The micro-kernel in use for T (decided once per type)
+ */
+template <typename T>
+const LeafKernel<T>& leafKernel() {
+    static const LeafKernel<T> selected = KernelSelector<T>::select();
+    return selected;
+}
+
+/**
+ * Pack an mc x kc block of A into MR-row slivers, zero-filling the ragged edge.
+ */
+template <typename T>
+void packA(ConstMatrixView<T> A, int mc, int kc, T* packed) {
+    const int MR = KernelShape<T>::MR;
+    for (int i0 = 0; i0 < mc; i0 += MR) {
+        for (int k = 0; k < kc; k++) {
+            for (int r = 0; r < MR; r++) {
+                *packed++ = (i0 + r < mc) ? A(i0 + r, k) : T();
+            }
+        }
+    }
+}
+
+/**
+ * Pack a kc x nc block of B into NR-column slivers, zero-filling the ragged edge.
+ */
+template <typename T>
+void packB(ConstMatrixView<T> B, int kc, int nc, T* packed) {
+    const int NR = KernelShape<T>::NR;
+    for (int j0 = 0; j0 < nc; j0 += NR) {
+        int width = std::min(NR, nc - j0);
+        for (int k = 0; k < kc; k++) {
+            const T* b = B.row(k) + j0;
+            int c = 0;
+            for (; c < width; c++) {
+                *packed++ = b[c];
+            }
+            for (; c < NR; c++) {
+                *packed++ = T();
+            }
+        }
+    }
+}
+
+/**
+ * Cache-blocked GEMM driver: C += A × B, or C = A × B when accumulate is false.
+ * Packing buffers are per thread and allocated once.
+ */
+template <typename T>
+void blockedMultiply(InputView<T> A, InputView<T> B, MatrixView<T> C, bool accumulate) {
+    const int MR = KernelShape<T>::MR;
+    const int NR = KernelShape<T>::NR;
+    int m = A.rows;
+    int n = B.cols;
+    int k = A.cols;
+
+    if (!accumulate) {
+        for (int i = 0; i < m; i++) {
+            std::fill(C.row(i), C.row(i) + n, T());
+        }
+    }
+
+    thread_local std::vector<T> packedA(static_cast<size_t>(KERNEL_MC) * KERNEL_KC);
+    thread_local std::vector<T> packedB(static_cast<size_t>(KERNEL_KC) * KERNEL_NC);
+    MicroKernel<T> kernel = leafKernel<T>().run;
+
+    for (int jc = 0; jc < n; jc += KERNEL_NC) {
+        int nc = std::min(KERNEL_NC, n - jc);
+        for (int pc = 0; pc < k; pc += KERNEL_KC) {
+            int kc = std::min(KERNEL_KC, k - pc);
+            packB(B.block(pc, jc, kc, nc), kc, nc, packedB.data());
+
+            for (int ic = 0; ic < m; ic += KERNEL_MC) {
+                int mc = std::min(KERNEL_MC, m - ic);
+                packA(A.block(ic, pc, mc, kc), mc, kc, packedA.data());
+
+                for (int jr = 0; jr < nc; jr += NR) {
+                    int nr = std::min(NR, nc - jr);
+                    const T* bPanel = packedB.data() + static_cast<size_t>(jr) * kc;
+
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        int mr = std::min(MR, mc - ir);
+                        const T* aPanel = packedA.data() + static_cast<size_t>(ir) * kc;
+                        T* c = C.row(ic + ir) + jc + jr;
+
+                        if (mr == MR && nr == NR) {
+                            kernel(kc, aPanel, bPanel, c, C.stride);
+                        } else {
+                            // Ragged edge: run the full tile into a scratch tile, keep the valid part
+                            T tile[MR * NR] = {};
+                            kernel(kc, aPanel, bPanel, tile, NR);
+                            for (int r = 0; r < mr; r++) {
+                                for (int col = 0; col < nr; col++) {
+                                    c[r * C.stride + col] += tile[r * NR + col];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
 
 // --- Helper Functions Declaration ---
 
-// Forward declarations for helper functions used by strassenRecursive
-Matrix standardMultiply(const Matrix& A, const Matrix& B);
-Matrix add(const Matrix& A, const Matrix& B);
-Matrix subtract(const Matrix& A, const Matrix& B);
-Matrix getSubMatrix(const Matrix& matrix, int row, int col, int size);
-Matrix combineMatrices(const Matrix& C11, const Matrix& C12, const Matrix& C21, const Matrix& C22);
-int nextPowerOfTwo(int n);
-bool isValidForMultiplication(const Matrix& A, const Matrix& B);
-Matrix padMatrix(const Matrix& matrix, int newSize);
-Matrix extractMatrix(const Matrix& matrix, int rows, int cols);
+// Forward declarations for helper functions used by strassenRecursive
+template <typename T> void standardMultiply(InputView<T> A, InputView<T> B, MatrixView<T> C);
+template <typename T> void add(InputView<T> A, InputView<T> B, MatrixView<T> result);
+template <typename T> void subtract(InputView<T> A, InputView<T> B, MatrixView<T> result);
+template <typename T> void copyInto(InputView<T> A, MatrixView<T> result);
+template <typename T> void addInPlace(InputView<T> A, MatrixView<T> result);
+template <typename T> void subtractInPlace(InputView<T> A, MatrixView<T> result);
+template <typename T> ConstMatrixView<T> getSubMatrix(ConstMatrixView<T> matrix, int row, int col, int rows, int cols);
+template <typename T> MatrixView<T> getSubMatrix(MatrixView<T> matrix, int row, int col, int rows, int cols);
+template <typename T> bool isValidForMultiplication(const Matrix<T>& A, const Matrix<T>& B);
+size_t strassenWorkspaceElements(int m, int k, int n, const StrassenContext& ctx, int parallelLevels, bool accumulate);
+
+// --- Core Strassen Logic ---
+
+/**
+ * How one recursion step treats an m x k by k x n product
+ */
+enum class SplitKind {
+    Leaf,        // smallest dimension at or below the threshold: use the blocked kernel
+    SplitRows,   // m dominates: C_top = A_top B, C_bottom = A_bottom B
+    SplitCols,   // n dominates: C_left = A B_left, C_right = A B_right
+    SplitInner,  // k dominates: C = A_left B_top + A_right B_bottom
+    Strassen     // roughly cubic: seven half-size products on the even core
+};
+
+/**
+ * Choose the next step from the actual shape. Long, thin shapes are cut along their
+ * largest dimension until they are within 2x of cubic, so a 100 x 4000 x 100
+ * product never grows into a padded 4096 cube.
+ */
+SplitKind chooseSplit(int m, int k, int n, int threshold) {
+    int smallest = std::min({m, k, n});
+    if (smallest <= threshold) {
+        return SplitKind::Leaf;
+    }
+    int largest = std::max({m, k, n});
+    if (largest >= 2 * smallest) {
+        if (largest == m) return SplitKind::SplitRows;
+        if (largest == n) return SplitKind::SplitCols;
+        return SplitKind::SplitInner;
+    }
+    return SplitKind::Strassen;
+}
+
+template <typename T>
+void strassenRecursive(InputView<T> A, InputView<T> B, MatrixView<T> C, Workspace<T>& ws,
+                       const StrassenContext& ctx, int parallelLevels, bool accumulate);
+
+/**
+ * Write a finished block into C, or add it when the caller is accumulating
+ */
+template <typename T>
+void storeResult(InputView<T> P, MatrixView<T> C, bool accumulate) {
+    if (accumulate) {
+        addInPlace(P, C);
+    } else {
+        copyInto(P, C);
+    }
+}
+
+/**
+ * Dynamic peeling: the Strassen step only covers the even core of each dimension.
+ * The leftover inner index, last column and last row are fixed up here with
+ * rank-1, matrix-vector and vector-matrix passes instead of padding.
+ */
+template <typename T>
+void peelOddEdges(InputView<T> A, InputView<T> B, MatrixView<T> C, bool accumulate) {
+    int m = A.rows;
+    int k = A.cols;
+    int n = B.cols;
+    int m2 = m & ~1;
+    int k2 = k & ~1;
+    int n2 = n & ~1;
+
+    // Odd k: C[0:m2, 0:n2] += A[:, k-1] * B[k-1, :]
+    if (k2 < k) {
+        const T* b = B.row(k2);
+        for (int i = 0; i < m2; i++) {
+            T a = A(i, k2);
+            T* c = C.row(i);
+            for (int j = 0; j < n2; j++) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+
+    // Odd n: C[0:m2, n-1] = A[0:m2, :] * B[:, n-1]
+    if (n2 < n) {
+        for (int i = 0; i < m2; i++) {
+            const T* a = A.row(i);
+            T sum = T();
+            for (int p = 0; p < k; p++) {
+                sum += a[p] * B(p, n2);
+            }
+            C(i, n2) = accumulate ? C(i, n2) + sum : sum;
+        }
+    }
+
+    // Odd m: C[m-1, :] = A[m-1, :] * B
+    if (m2 < m) {
+        T* c = C.row(m2);
+        if (!accumulate) {
+            std::fill(c, c + n, T());
+        }
+        for (int p = 0; p < k; p++) {
+            T a = A(m2, p);
+            const T* b = B.row(p);
+            for (int j = 0; j < n; j++) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+/**
+ * One task-parallel Strassen level: M1..M7 are independent, so each runs as a
+ * pool task with its own operand blocks, product block and child arena.
+ * The C quadrants are combined once all seven products are done.
+ */
+template <typename T>
+void strassenParallelLevel(InputView<T> A, InputView<T> B, MatrixView<T> C, Workspace<T>& ws,
+                           const StrassenContext& ctx, int parallelLevels, bool accumulate) {
+    int hm = A.rows / 2;
+    int hk = A.cols / 2;
+    int hn = B.cols / 2;
+    int next = parallelLevels - 1;
+
+    ConstMatrixView<T> A11 = getSubMatrix(A, 0, 0, hm, hk);
+    ConstMatrixView<T> A12 = getSubMatrix(A, 0, hk, hm, hk);
+    ConstMatrixView<T> A21 = getSubMatrix(A, hm, 0, hm, hk);
+    ConstMatrixView<T> A22 = getSubMatrix(A, hm, hk, hm, hk);
+
+    ConstMatrixView<T> B11 = getSubMatrix(B, 0, 0, hk, hn);
+    ConstMatrixView<T> B12 = getSubMatrix(B, 0, hn, hk, hn);
+    ConstMatrixView<T> B21 = getSubMatrix(B, hk, 0, hk, hn);
+    ConstMatrixView<T> B22 = getSubMatrix(B, hk, hn, hk, hn);
+
+    size_t mark = ws.mark();
+    size_t childElements = strassenWorkspaceElements(hm, hk, hn, ctx, next, false);
+
+    MatrixView<T> M[7];
+    std::vector<Workspace<T>> arenas;
+    arenas.reserve(7);
+    for (int i = 0; i < 7; i++) {
+        M[i] = ws.allocate(hm, hn);
+        arenas.push_back(ws.split(childElements));
+    }
+
+    // Ten operand sums: five on the A side, five on the B side
+    MatrixView<T> S1 = ws.allocate(hm, hk), T1 = ws.allocate(hk, hn);
+    MatrixView<T> S2 = ws.allocate(hm, hk);
+    MatrixView<T> T3 = ws.allocate(hk, hn);
+    MatrixView<T> T4 = ws.allocate(hk, hn);
+    MatrixView<T> S5 = ws.allocate(hm, hk);
+    MatrixView<T> S6 = ws.allocate(hm, hk), T6 = ws.allocate(hk, hn);
+    MatrixView<T> S7 = ws.allocate(hm, hk), T7 = ws.allocate(hk, hn);
+
+    TaskGroup products(*ctx.pool);
+    // M1 = (A11 + A22) * (B11 + B22)
+    products.run([&] {
+        add(A11, A22, S1);
+        add(B11, B22, T1);
+        strassenRecursive(S1, T1, M[0], arenas[0], ctx, next, false);
+    });
+    // M2 = (A21 + A22) * B11
+    products.run([&] {
+        add(A21, A22, S2);
+        strassenRecursive(S2, B11, M[1], arenas[1], ctx, next, false);
+    });
+    // M3 = A11 * (B12 - B22)
+    products.run([&] {
+        subtract(B12, B22, T3);
+        strassenRecursive(A11, T3, M[2], arenas[2], ctx, next, false);
+    });
+    // M4 = A22 * (B21 - B11)
+    products.run([&] {
+        subtract(B21, B11, T4);
+        strassenRecursive(A22, T4, M[3], arenas[3], ctx, next, false);
+    });
+    // M5 = (A11 + A12) * B22
+    products.run([&] {
+        add(A11, A12, S5);
+        strassenRecursive(S5, B22, M[4], arenas[4], ctx, next, false);
+    });
+    // M6 = (A21 - A11) * (B11 + B12)
+    products.run([&] {
+        subtract(A21, A11, S6);
+        add(B11, B12, T6);
+        strassenRecursive(S6, T6, M[5], arenas[5], ctx, next, false);
+    });
+    // M7 = (A12 - A22) * (B21 + B22)
+    products.run([&] {
+        subtract(A12, A22, S7);
+        add(B21, B22, T7);
+        strassenRecursive(S7, T7, M[6], arenas[6], ctx, next, false);
+    });
+    products.wait();
+
+    // Combine, one task per output quadrant
+    TaskGroup quadrants(*ctx.pool);
+    quadrants.run([&] {
+        // C11 = M1 + M4 - M5 + M7
+        MatrixView<T> C11 = getSubMatrix(C, 0, 0, hm, hn);
+        storeResult(M[0], C11, accumulate);
+        addInPlace(M[3], C11);
+        subtractInPlace(M[4], C11);
+        addInPlace(M[6], C11);
+    });
+    quadrants.run([&] {
+        // C12 = M3 + M5
+        MatrixView<T> C12 = getSubMatrix(C, 0, hn, hm, hn);
+        storeResult(M[2], C12, accumulate);
+        addInPlace(M[4], C12);
+    });
+    quadrants.run([&] {
+        // C21 = M2 + M4
+        MatrixView<T> C21 = getSubMatrix(C, hm, 0, hm, hn);
+        storeResult(M[1], C21, accumulate);
+        addInPlace(M[3], C21);
+    });
+    quadrants.run([&] {
+        // C22 = M1 - M2 + M3 + M6
+        MatrixView<T> C22 = getSubMatrix(C, hm, hn, hm, hn);
+        storeResult(M[0], C22, accumulate);
+        subtractInPlace(M[1], C22);
+        addInPlace(M[2], C22);
+        addInPlace(M[5], C22);
+    });
+    quadrants.wait();
+
+    ws.release(mark);
+}
+
+/**
+ * One sequential Strassen level on an even-sized (2hm x 2hk) by (2hk x 2hn) core.
+ * Three scratch blocks are enough: the two operand sums (SA, SB) and the current product,
+ * which is folded into the C quadrants as soon as it is computed.
+ */
+template <typename T>
+void strassenSequentialLevel(InputView<T> A, InputView<T> B, MatrixView<T> C, Workspace<T>& ws,
+                             const StrassenContext& ctx, bool accumulate) {
+    int hm = A.rows / 2;
+    int hk = A.cols / 2;
+    int hn = B.cols / 2;
+
+    // --- 1. Divide matrices into quadrants (views, no copies) ---
+    ConstMatrixView<T> A11 = getSubMatrix(A, 0, 0, hm, hk);
+    ConstMatrixView<T> A12 = getSubMatrix(A, 0, hk, hm, hk);
+    ConstMatrixView<T> A21 = getSubMatrix(A, hm, 0, hm, hk);
+    ConstMatrixView<T> A22 = getSubMatrix(A, hm, hk, hm, hk);
+
+    ConstMatrixView<T> B11 = getSubMatrix(B, 0, 0, hk, hn);
+    ConstMatrixView<T> B12 = getSubMatrix(B, 0, hn, hk, hn);
+    ConstMatrixView<T> B21 = getSubMatrix(B, hk, 0, hk, hn);
+    ConstMatrixView<T> B22 = getSubMatrix(B, hk, hn, hk, hn);
+
+    MatrixView<T> C11 = getSubMatrix(C, 0, 0, hm, hn);
+    MatrixView<T> C12 = getSubMatrix(C, 0, hn, hm, hn);
+    MatrixView<T> C21 = getSubMatrix(C, hm, 0, hm, hn);
+    MatrixView<T> C22 = getSubMatrix(C, hm, hn, hm, hn);
+
+    size_t mark = ws.mark();
+    MatrixView<T> SA = ws.allocate(hm, hk);
+    MatrixView<T> SB = ws.allocate(hk, hn);
+    MatrixView<T> P = ws.allocate(hm, hn);
+
+    // --- 2. Calculate the 7 products (M1 to M7) and accumulate into C ---
+    // C11 = M1 + M4 - M5 + M7
+    // C12 = M3 + M5
+    // C21 = M2 + M4
+    // C22 = M1 - M2 + M3 + M6
+
+    // M1 = (A11 + A22) * (B11 + B22)
+    add(A11, A22, SA);
+    add(B11, B22, SB);
+    strassenRecursive(SA, SB, P, ws, ctx, 0, false);
+    storeResult(P, C11, accumulate);
+    storeResult(P, C22, accumulate);
+    // M2 = (A21 + A22) * B11
+    add(A21, A22, SA);
+    strassenRecursive(SA, B11, P, ws, ctx, 0, false);
+    storeResult(P, C21, accumulate);
+    subtractInPlace(P, C22);
+    // M3 = A11 * (B12 - B22)
+    subtract(B12, B22, SB);
+    strassenRecursive(A11, SB, P, ws, ctx, 0, false);
+    storeResult(P, C12, accumulate);
+    addInPlace(P, C22);
+    // M4 = A22 * (B21 - B11)
+    subtract(B21, B11, SB);
+    strassenRecursive(A22, SB, P, ws, ctx, 0, false);
+    addInPlace(P, C11);
+    addInPlace(P, C21);
+    // M5 = (A11 + A12) * B22
+    add(A11, A12, SA);
+    strassenRecursive(SA, B22, P, ws, ctx, 0, false);
+    subtractInPlace(P, C11);
+    addInPlace(P, C12);
+    // M6 = (A21 - A11) * (B11 + B12)
+    subtract(A21, A11, SA);
+    add(B11, B12, SB);
+    strassenRecursive(SA, SB, P, ws, ctx, 0, false);
+    addInPlace(P, C22);
+    // M7 = (A12 - A22) * (B21 + B22)
+    subtract(A12, A22, SA);
+    add(B21, B22, SB);
+    strassenRecursive(SA, SB, P, ws, ctx, 0, false);
+    addInPlace(P, C11);
+
+    ws.release(mark);
+}
+
+/**
+ * One sequential level in the Strassen-Winograd order (Boyer, Dumas, Pernet and Zhou's
+ * in-place schedule). Seven products and 15 block additions instead of 18; the products
+ * land directly in the C quadrants, so only two scratch blocks are needed: X holds the
+ * A-side sums and then P1, Y holds the B-side sums. C must not be accumulated into,
+ * since every quadrant is used as scratch before it holds its final value.
+ */
+template <typename T>
+void winogradSequentialLevel(InputView<T> A, InputView<T> B, MatrixView<T> C, Workspace<T>& ws,
+                             const StrassenContext& ctx) {
+    int hm = A.rows / 2;
+    int hk = A.cols / 2;
+    int hn = B.cols / 2;
+
+    ConstMatrixView<T> A11 = getSubMatrix(A, 0, 0, hm, hk);
+    ConstMatrixView<T> A12 = getSubMatrix(A, 0, hk, hm, hk);
+    ConstMatrixView<T> A21 = getSubMatrix(A, hm, 0, hm, hk);
+    ConstMatrixView<T> A22 = getSubMatrix(A, hm, hk, hm, hk);
+
+    ConstMatrixView<T> B11 = getSubMatrix(B, 0, 0, hk, hn);
+    ConstMatrixView<T> B12 = getSubMatrix(B, 0, hn, hk, hn);
+    ConstMatrixView<T> B21 = getSubMatrix(B, hk, 0, hk, hn);
+    ConstMatrixView<T> B22 = getSubMatrix(B, hk, hn, hk, hn);
+
+    MatrixView<T> C11 = getSubMatrix(C, 0, 0, hm, hn);
+    MatrixView<T> C12 = getSubMatrix(C, 0, hn, hm, hn);
+    MatrixView<T> C21 = getSubMatrix(C, hm, 0, hm, hn);
+    MatrixView<T> C22 = getSubMatrix(C, hm, hn, hm, hn);
+
+    size_t mark = ws.mark();
+    // X is shared by the hm x hk operand sums and the hm x hn product P1
+    MatrixView<T> scratch = ws.allocate(hm, std::max(hk, hn));
+    MatrixView<T> X{scratch.data, hm, hk, hk};
+    MatrixView<T> P1{scratch.data, hm, hn, hn};
+    MatrixView<T> Y = ws.allocate(hk, hn);
+
+    // Operand sums:  S1 = A21 + A22, S2 = S1 - A11, S3 = A11 - A21, S4 = A12 - S2
+    //                T1 = B12 - B11, T2 = B22 - T1, T3 = B22 - B12, T4 = T2 - B21
+    // Products:      P1 = A11 B11, P2 = A12 B21, P3 = S4 B22, P4 = A22 T4,
+    //                P5 = S1 T1,   P6 = S2 T2,   P7 = S3 T3
+    // Result:        U2 = P1 + P6, U3 = U2 + P7, U4 = U2 + P5
+    //                C11 = P1 + P2, C12 = U4 + P3, C21 = U3 - P4, C22 = U3 + P5
+
+    subtract(A11, A21, X);                        // X = S3
+    subtract(B22, B12, Y);                        // Y = T3
+    strassenRecursive(X, Y, C21, ws, ctx, 0, false);  // C21 = P7
+    add(A21, A22, X);                             // X = S1
+    subtract(B12, B11, Y);                        // Y = T1
+    strassenRecursive(X, Y, C22, ws, ctx, 0, false);  // C22 = P5
+    subtractInPlace(A11, X);                      // X = S2
+    subtract(B22, Y, Y);                          // Y = T2
+    strassenRecursive(X, Y, C12, ws, ctx, 0, false);  // C12 = P6
+    subtract(A12, X, X);                          // X = S4
+    strassenRecursive(X, B22, C11, ws, ctx, 0, false);  // C11 = P3
+    strassenRecursive(A11, B11, P1, ws, ctx, 0, false); // X = P1
+    addInPlace(P1, C12);                          // C12 = U2
+    addInPlace(C12, C21);                         // C21 = U3
+    addInPlace(C22, C12);                         // C12 = U4
+    addInPlace(C21, C22);                         // C22 = U3 + P5 (final)
+    addInPlace(C11, C12);                         // C12 = U4 + P3 (final)
+    subtractInPlace(B21, Y);                      // Y = T4
+    strassenRecursive(A22, Y, C11, ws, ctx, 0, false);  // C11 = P4
+    subtractInPlace(C11, C21);                    // C21 = U3 - P4 (final)
+    strassenRecursive(A12, B21, C11, ws, ctx, 0, false); // C11 = P2
+    addInPlace(P1, C11);                          // C11 = P1 + P2 (final)
+
+    ws.release(mark);
+}
 
-// --- Core Strassen Logic ---
+/**
+ * Two independent sub-products (a row or column split). On a parallel level they
+ * run as two tasks with their own arenas, otherwise one after the other.
+ */
+template <typename T>
+void multiplyPair(InputView<T> A1, InputView<T> B1, MatrixView<T> C1,
+                  InputView<T> A2, InputView<T> B2, MatrixView<T> C2,
+                  Workspace<T>& ws, const StrassenContext& ctx, int parallelLevels, bool accumulate) {
+    if (!ctx.pool || parallelLevels == 0) {
+        strassenRecursive(A1, B1, C1, ws, ctx, parallelLevels, accumulate);
+        strassenRecursive(A2, B2, C2, ws, ctx, parallelLevels, accumulate);
+        return;
+    }
+
+    int next = parallelLevels - 1;
+    size_t mark = ws.mark();
+    Workspace<T> first = ws.split(strassenWorkspaceElements(A1.rows, A1.cols, B1.cols, ctx, next, accumulate));
+    Workspace<T> second = ws.split(strassenWorkspaceElements(A2.rows, A2.cols, B2.cols, ctx, next, accumulate));
+
+    TaskGroup halves(*ctx.pool);
+    halves.run([&] { strassenRecursive(A1, B1, C1, first, ctx, next, accumulate); });
+    halves.run([&] { strassenRecursive(A2, B2, C2, second, ctx, next, accumulate); });
+    halves.wait();
+
+    ws.release(mark);
+}
 
 /**
- * Recursive implementation of Strassen's algorithm
- * * @param A First matrix (must be square and power of 2)
- * @param B Second matrix (must be square and power of 2)
- * @return Result matrix A × B
+ * Recursive implementation of Strassen's algorithm for any shape
+ * * @param A First matrix view (m x k)
+ * @param B Second matrix view (k x n)
+ * @param C Output view (m x n) receiving A × B, or C + A × B when accumulating
+ * @param ws Arena providing this level's scratch blocks
+ * @param ctx Threshold and thread pool for this multiply
+ * @param parallelLevels How many more levels should fork their products as tasks
+ * @param accumulate Add into C instead of overwriting it
  */
-Matrix strassenRecursive(const Matrix& A, const Matrix& B) {
-    int n = A.size();
+template <typename T>
+void strassenRecursive(InputView<T> A, InputView<T> B, MatrixView<T> C, Workspace<T>& ws,
+                       const StrassenContext& ctx, int parallelLevels, bool accumulate) {
+    int m = A.rows;
+    int k = A.cols;
+    int n = B.cols;
+
+    switch (chooseSplit(m, k, n, ctx.threshold)) {
+        case SplitKind::Leaf:
+            // Base case: use standard multiplication for small matrices
+            blockedMultiply(A, B, C, accumulate);
+            return;
+
+        case SplitKind::SplitRows: {
+            int top = m / 2;
+            multiplyPair(A.block(0, 0, top, k), B, C.block(0, 0, top, n),
+                         A.block(top, 0, m - top, k), B, C.block(top, 0, m - top, n),
+                         ws, ctx, parallelLevels, accumulate);
+            return;
+        }
+
+        case SplitKind::SplitCols: {
+            int left = n / 2;
+            multiplyPair(A, B.block(0, 0, k, left), C.block(0, 0, m, left),
+                         A, B.block(0, left, k, n - left), C.block(0, left, m, n - left),
+                         ws, ctx, parallelLevels, accumulate);
+            return;
+        }
+
+        case SplitKind::SplitInner: {
+            // Both halves write the same C, so the second one accumulates
+            int left = k / 2;
+            strassenRecursive(A.block(0, 0, m, left), B.block(0, 0, left, n), C, ws, ctx, parallelLevels, accumulate);
+            strassenRecursive(A.block(0, left, m, k - left), B.block(left, 0, k - left, n), C, ws, ctx, parallelLevels, true);
+            return;
+        }
 
-    // Base case: use standard multiplication for small matrices
-    if (n <= THRESHOLD) {
-        return standardMultiply(A, B);
+        case SplitKind::Strassen:
+            break;
     }
 
-    int half = n / 2;
+    // Strassen on the even core, then peel the odd row/column/inner index
+    int m2 = m & ~1;
+    int k2 = k & ~1;
+    int n2 = n & ~1;
+    ConstMatrixView<T> Acore = A.block(0, 0, m2, k2);
+    ConstMatrixView<T> Bcore = B.block(0, 0, k2, n2);
+    MatrixView<T> Ccore = C.block(0, 0, m2, n2);
+
+    if (ctx.pool && parallelLevels > 0) {
+        strassenParallelLevel(Acore, Bcore, Ccore, ws, ctx, parallelLevels, accumulate);
+    } else if (ctx.schedule == StrassenSchedule::Winograd && !accumulate) {
+        winogradSequentialLevel(Acore, Bcore, Ccore, ws, ctx);
+    } else {
+        // The in-place Winograd order overwrites C, so accumulating levels stay classic
+        strassenSequentialLevel(Acore, Bcore, Ccore, ws, ctx, accumulate);
+    }
 
-    // --- 1. Divide matrices into quadrants ---
-    Matrix A11 = getSubMatrix(A, 0, 0, half);
-    Matrix A12 = getSubMatrix(A, 0, half, half);
-    Matrix A21 = getSubMatrix(A, half, 0, half);
-    Matrix A22 = getSubMatrix(A, half, half, half);
+    peelOddEdges(A, B, C, accumulate);
+}
 
-    Matrix B11 = getSubMatrix(B, 0, 0, half);
-    Matrix B12 = getSubMatrix(B, 0, half, half);
-    Matrix B21 = getSubMatrix(B, half, 0, half);
-    Matrix B22 = getSubMatrix(B, half, half, half);
+/**
+ * Run the recursion on views that are already in the compute type
+ */
+template <typename T>
+Matrix<T> strassenMultiplyViews(ConstMatrixView<T> A, ConstMatrixView<T> B, const StrassenOptions& options) {
+    int m = A.rows;
+    int k = A.cols;
+    int n = B.cols;
 
-    // --- 2. Calculate the 7 products (M1 to M7) using Strassen's formulas ---
-    // M1 = (A11 + A22) * (B11 + B22)
-    Matrix M1 = strassenRecursive(add(A11, A22), add(B11, B22)); 
-    // M2 = (A21 + A22) * B11
-    Matrix M2 = strassenRecursive(add(A21, A22), B11);
-    // M3 = A11 * (B12 - B22)
-    Matrix M3 = strassenRecursive(A11, subtract(B12, B22));
-    // M4 = A22 * (B21 - B11)
-    Matrix M4 = strassenRecursive(A22, subtract(B21, B11));
-    // M5 = (A11 + A12) * B22
-    Matrix M5 = strassenRecursive(add(A11, A12), B22);
-    // M6 = (A21 - A11) * (B11 + B12)
-    Matrix M6 = strassenRecursive(subtract(A21, A11), add(B11, B12));
-    // M7 = (A12 - A22) * (B21 + B22)
-    Matrix M7 = strassenRecursive(subtract(A12, A22), add(B21, B22));
+    StrassenContext ctx{effectiveThreshold(options), options.schedule, sharedPool(options.threads)};
+    int parallelLevels = ctx.pool ? options.parallelDepth : 0;
 
-    // --- 3. Calculate result quadrants (C11, C12, C21, C22) ---
-    // C11 = M1 + M4 - M5 + M7
-    Matrix C11 = add(subtract(add(M1, M4), M5), M7);
-    // C12 = M3 + M5
-    Matrix C12 = add(M3, M5);
-    // C21 = M2 + M4
-    Matrix C21 = add(M2, M4);
-    // C22 = M1 + M3 - M2 + M6
-    Matrix C22 = add(subtract(add(M1, M3), M2), M6);
+    // Size the arena once for the whole recursion; no padded copies are made
+    Workspace<T> ws(strassenWorkspaceElements(m, k, n, ctx, parallelLevels, false));
 
-    // --- 4. Combine quadrants into result matrix ---
-    return combineMatrices(C11, C12, C21, C22);
+    Matrix<T> result(m, n);
+    strassenRecursive(A, B, result.view(), ws, ctx, parallelLevels, false);
+    return result;
 }
 
 /**
  * Multiply two matrices using Strassen's algorithm (main public method)
  * * @param A First matrix
  * @param B Second matrix
- * @return Result matrix A × B
+ * @param options Thread count, parallel depth, threshold override and schedule
+ * @return Result matrix A × B in the accumulator type (int64 for int32 inputs)
  * @throws std::invalid_argument if matrices cannot be multiplied
  */
-Matrix strassenMultiply(const Matrix& A, const Matrix& B) {
+template <typename T>
+Matrix<Accumulator<T>> strassenMultiply(const Matrix<T>& A, const Matrix<T>& B,
+                                        const StrassenOptions& options = StrassenOptions()) {
+    using Acc = Accumulator<T>;
+
     // Validate input matrices
     if (!isValidForMultiplication(A, B)) {
         throw std::invalid_argument("Invalid matrices for multiplication: columns of A must equal rows of B.");
     }
 
-    int aRows = A.size();
-    int aCols = A[0].size();
-    int bRows = B.size();
-    int bCols = B[0].size();
+    if constexpr (std::is_same<T, Acc>::value) {
+        return strassenMultiplyViews<Acc>(A.view(), B.view(), options);
+    } else {
+        // Widen once up front; every operand sum and product then runs in Acc
+        Matrix<Acc> wideA = convertMatrix<Acc>(A);
+        Matrix<Acc> wideB = convertMatrix<Acc>(B);
+        return strassenMultiplyViews<Acc>(wideA.view(), wideB.view(), options);
+    }
+}
+
+/**
+ * Number of elements the workspace arena needs for an m x k by k x n multiply.
+ * Mirrors the decisions strassenRecursive makes: three blocks per classic sequential
+ * level, two per Winograd level, 17 blocks plus seven child arenas per task-parallel
+ * level, and for splits the larger half (sequential) or both halves (parallel).
+ * The pool in ctx is ignored; parallelLevels alone says which levels fork.
+ */
+size_t strassenWorkspaceElements(int m, int k, int n, const StrassenContext& ctx, int parallelLevels, bool accumulate) {
+    switch (chooseSplit(m, k, n, ctx.threshold)) {
+        case SplitKind::Leaf:
+            return 0;
+
+        case SplitKind::SplitRows:
+        case SplitKind::SplitCols: {
+            bool rows = chooseSplit(m, k, n, ctx.threshold) == SplitKind::SplitRows;
+            int first = (rows ? m : n) / 2;
+            int second = (rows ? m : n) - first;
+            if (parallelLevels > 0) {
+                return strassenWorkspaceElements(rows ? first : m, k, rows ? n : first, ctx, parallelLevels - 1, accumulate)
+                     + strassenWorkspaceElements(rows ? second : m, k, rows ? n : second, ctx, parallelLevels - 1, accumulate);
+            }
+            return std::max(strassenWorkspaceElements(rows ? first : m, k, rows ? n : first, ctx, 0, accumulate),
+                            strassenWorkspaceElements(rows ? second : m, k, rows ? n : second, ctx, 0, accumulate));
+        }
+
+        case SplitKind::SplitInner: {
+            int left = k / 2;
+            return std::max(strassenWorkspaceElements(m, left, n, ctx, parallelLevels, accumulate),
+                            strassenWorkspaceElements(m, k - left, n, ctx, parallelLevels, true));
+        }
+
+        case SplitKind::Strassen:
+            break;
+    }
+
+    int hm = m / 2;
+    int hk = k / 2;
+    int hn = n / 2;
+    size_t aBlock = arenaBlockSize(hm, hk);
+    size_t bBlock = arenaBlockSize(hk, hn);
+    size_t cBlock = arenaBlockSize(hm, hn);
+
+    if (parallelLevels > 0) {
+        return 5 * aBlock + 5 * bBlock + 7 * cBlock
+             + 7 * strassenWorkspaceElements(hm, hk, hn, ctx, parallelLevels - 1, false);
+    }
+    size_t child = strassenWorkspaceElements(hm, hk, hn, ctx, 0, false);
+    if (ctx.schedule == StrassenSchedule::Winograd && !accumulate) {
+        return arenaBlockSize(hm, std::max(hk, hn)) + bBlock + child;
+    }
+    return aBlock + bBlock + cBlock + child;
+}
+
+/**
+ * Peak heap footprint of strassenMultiply<T> in bytes: the result plus the
+ * workspace arena, and the widened input copies when T has a wider accumulator.
+ */
+template <typename T>
+size_t strassenPeakBytes(int aRows, int aCols, int bCols, const StrassenOptions& options) {
+    using Acc = Accumulator<T>;
+    int parallelLevels = options.threads > 1 ? options.parallelDepth : 0;
+    StrassenContext plan{effectiveThreshold(options), options.schedule, nullptr};
+    size_t elements = static_cast<size_t>(aRows) * bCols
+                    + strassenWorkspaceElements(aRows, aCols, bCols, plan, parallelLevels, false);
+    if (!std::is_same<T, Acc>::value) {
+        elements += static_cast<size_t>(aRows) * aCols + static_cast<size_t>(aCols) * bCols;
+    }
+    return elements * sizeof(Acc);
+}
+
+// --- Batched Small Multiplies ---
+
+// The per-pair kernels are force-inlined into each ISA-specific batch loop below,
+// so the compiler vectorizes them for that instruction set
+#ifdef STRASSEN_X86_KERNELS
+#define BATCH_INLINE __attribute__((always_inline)) inline
+#else
+#define BATCH_INLINE inline
+#endif
+
+/**
+ * C = A × B for one n x n pair with the size fixed at compile time, so every loop
+ * bound is a constant and the row accumulator can live in registers.
+ * Inputs are widened to the accumulator type like strassenMultiply does.
+ */
+template <typename T, int N>
+BATCH_INLINE void smallMultiplyFixed(const T* A, const T* B, Accumulator<T>* C) {
+    using Acc = Accumulator<T>;
+    if constexpr (IsModInt<T>::value) {
+        // Lazy reduction as in microKernelModular: sum in uint64, reduce once per entry
+        const uint64_t P = T::modulus;
+        const uint64_t fold = ((uint64_t(1) << 63) / (P * P)) * (P * P);
+        for (int i = 0; i < N; i++) {
+            uint64_t row[N] = {};
+            for (int p = 0; p < N; p++) {
+                uint64_t a = A[i * N + p].value;
+                for (int j = 0; j < N; j++) {
+                    uint64_t sum = row[j] + a * B[p * N + j].value;
+                    row[j] = sum >= fold ? sum - fold : sum;
+                }
+            }
+            for (int j = 0; j < N; j++) {
+                C[i * N + j] = T(static_cast<long long>(row[j] % P));
+            }
+        }
+        return;
+    }
+    for (int i = 0; i < N; i++) {
+        Acc row[N] = {};
+        for (int p = 0; p < N; p++) {
+            Acc a = static_cast<Acc>(A[i * N + p]);
+            for (int j = 0; j < N; j++) {
+                row[j] += a * static_cast<Acc>(B[p * N + j]);
+            }
+        }
+        std::copy(row, row + N, C + i * N);
+    }
+}
+
+/**
+ * Runtime-sized fallback for shapes without a fixed-size kernel
+ */
+template <typename T>
+BATCH_INLINE void smallMultiply(const T* A, const T* B, Accumulator<T>* C, int m, int k, int n) {
+    using Acc = Accumulator<T>;
+    std::fill(C, C + static_cast<size_t>(m) * n, Acc());
+    for (int i = 0; i < m; i++) {
+        Acc* c = C + static_cast<size_t>(i) * n;
+        for (int p = 0; p < k; p++) {
+            Acc a = static_cast<Acc>(A[static_cast<size_t>(i) * k + p]);
+            const T* b = B + static_cast<size_t>(p) * n;
+            for (int j = 0; j < n; j++) {
+                c[j] += a * static_cast<Acc>(b[j]);
+            }
+        }
+    }
+}
+
+/**
+ * Multiply pairs [begin, end) of a batch. N > 0 selects the fixed-size kernel;
+ * N == 0 uses the runtime-sized one.
+ */
+template <typename T, int N>
+BATCH_INLINE void batchLoop(const T* A, const T* B, Accumulator<T>* C, size_t begin, size_t end, int m, int k, int n) {
+    size_t aSize = static_cast<size_t>(m) * k;
+    size_t bSize = static_cast<size_t>(k) * n;
+    size_t cSize = static_cast<size_t>(m) * n;
+    for (size_t b = begin; b < end; b++) {
+        if constexpr (N > 0) {
+            smallMultiplyFixed<T, N>(A + b * aSize, B + b * bSize, C + b * cSize);
+        } else {
+            smallMultiply(A + b * aSize, B + b * bSize, C + b * cSize, m, k, n);
+        }
+    }
+}
+
+template <typename T, int N>
+void batchRangePortable(const T* A, const T* B, Accumulator<T>* C, size_t begin, size_t end, int m, int k, int n) {
+    batchLoop<T, N>(A, B, C, begin, end, m, k, n);
+}
+
+#ifdef STRASSEN_X86_KERNELS
+template <typename T, int N>
+__attribute__((target("avx2,fma")))
+void batchRangeAvx2(const T* A, const T* B, Accumulator<T>* C, size_t begin, size_t end, int m, int k, int n) {
+    batchLoop<T, N>(A, B, C, begin, end, m, k, n);
+}
+
+template <typename T, int N>
+__attribute__((target("avx512f,avx512dq")))
+void batchRangeAvx512(const T* A, const T* B, Accumulator<T>* C, size_t begin, size_t end, int m, int k, int n) {
+    batchLoop<T, N>(A, B, C, begin, end, m, k, n);
+}
+#endif
+
+template <typename T>
+using BatchRangeFn = void (*)(const T*, const T*, Accumulator<T>*, size_t, size_t, int, int, int);
+
+/**
+ * Batch loop chosen for one shape and CPU
+ */
+template <typename T>
+struct BatchKernel {
+    BatchRangeFn<T> run;
+    const char* name;
+};
+
+template <typename T, int N>
+BatchKernel<T> batchKernelVariant() {
+#ifdef STRASSEN_X86_KERNELS
+    using Acc = Accumulator<T>;
+    __builtin_cpu_init();
+    // 64-bit integer multiplies gain little from AVX-512 here
+    if (std::is_floating_point<Acc>::value && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return {batchRangeAvx512<T, N>, "avx512"};
+    }
+    if ((std::is_arithmetic<Acc>::value || (IsModInt<Acc>::value && N > 0))
+        && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return {batchRangeAvx2<T, N>, "avx2+fma"};
+    }
+#endif
+    return {batchRangePortable<T, N>, "portable"};
+}
+
+/**
+ * Pick the kernel for one batch shape: square sizes with a compile-time kernel,
+ * anything else the runtime-sized loop
+ */
+template <typename T>
+BatchKernel<T> batchKernelFor(int m, int k, int n) {
+    if (m == k && k == n) {
+        switch (n) {
+            case 2: return batchKernelVariant<T, 2>();
+            case 3: return batchKernelVariant<T, 3>();
+            case 4: return batchKernelVariant<T, 4>();
+            case 8: return batchKernelVariant<T, 8>();
+            case 16: return batchKernelVariant<T, 16>();
+            case 32: return batchKernelVariant<T, 32>();
+        }
+    }
+    return batchKernelVariant<T, 0>();
+}
+
+// Smallest number of pairs worth handing to a pool task
+const size_t BATCH_MIN_CHUNK = 256;
+
+/**
+ * Multiply count independent pairs: C[i] = A[i] × B[i].
+ * Each buffer holds its matrices back to back in row-major order: A has count
+ * m x k matrices, B count k x n and C count m x n (in the accumulator type).
+ * Shapes are validated once for the whole batch, nothing is allocated per pair,
+ * and with options.threads > 1 the batch is split into chunks run on the shared pool.
+ * * @throws std::invalid_argument if a dimension is not positive
+ */
+template <typename T>
+void batchedMultiply(const T* A, const T* B, Accumulator<T>* C, size_t count, int m, int k, int n,
+                     const StrassenOptions& options = StrassenOptions()) {
+    if (m <= 0 || k <= 0 || n <= 0) {
+        throw std::invalid_argument("Invalid batch shape: dimensions must be positive.");
+    }
+
+    BatchRangeFn<T> kernel = batchKernelFor<T>(m, k, n).run;
+    ThreadPool* pool = sharedPool(options.threads);
+    if (!pool || count < 2 * BATCH_MIN_CHUNK) {
+        kernel(A, B, C, 0, count, m, k, n);
+        return;
+    }
+
+    // A few chunks per thread so stealing can even out the load
+    size_t chunks = std::min(count / BATCH_MIN_CHUNK, static_cast<size_t>(options.threads) * 4);
+    size_t chunkSize = (count + chunks - 1) / chunks;
+
+    TaskGroup group(*pool);
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        size_t end = std::min(count, begin + chunkSize);
+        group.run([=] { kernel(A, B, C, begin, end, m, k, n); });
+    }
+    group.wait();
+}
+
+// --- Out-of-Core Multiply ---
+
+// Tiled files start with a header padded to this many bytes, so tile data is page aligned
+const size_t TILED_HEADER_BYTES = 4096;
+
+/**
+ * Header of a binary tiled matrix file. Fields are fixed-width and stored in the
+ * writing machine's byte order; elementType and elementSize guard against opening
+ * a file with the wrong element type.
+ */
+struct TiledFileHeader {
+    char magic[8];         // "STRTILE1"
+    uint32_t elementType;  // elementTypeCode<T>()
+    uint32_t elementSize;  // sizeof(T)
+    uint64_t rows;
+    uint64_t cols;
+    uint32_t tile;         // tiles are tile x tile elements
+    uint32_t reserved;
+};
+
+const char TILED_MAGIC[8] = {'S', 'T', 'R', 'T', 'I', 'L', 'E', '1'};
+
+#if STRASSEN_HAS_MMAP
+
+/**
+ * Matrix stored on disk as a grid of square tiles and memory-mapped.
+ * Layout: TILED_HEADER_BYTES of header, then the tiles in row-major tile order,
+ * each one tile x tile elements in row-major order. Edge tiles are zero-padded to
+ * full size, so every tile sits at a fixed offset and is a valid kernel operand
+ * in place. Only the tiles being touched are resident; evict() hands the pages
+ * back to the kernel once a tile is done with.
+ */
+template <typename T>
+class TiledMatrixFile {
+public:
+    /**
+     * Create (or truncate) a zero-filled file for a rows x cols matrix
+     */
+    static TiledMatrixFile create(const std::string& path, int64_t rows, int64_t cols, int tile) {
+        if (rows <= 0 || cols <= 0 || tile <= 0) {
+            throw std::invalid_argument("Tiled matrix dimensions and tile size must be positive.");
+        }
+        TiledMatrixFile file(rows, cols, tile, true);
+        file.fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (file.fd_ < 0 || ::ftruncate(file.fd_, static_cast<off_t>(file.bytes_)) != 0) {
+            throw std::runtime_error("Cannot create tiled matrix file " + path);
+        }
+        file.map(path);
+
+        TiledFileHeader header = {};
+        std::copy(TILED_MAGIC, TILED_MAGIC + 8, header.magic);
+        header.elementType = elementTypeCode<T>();
+        header.elementSize = sizeof(T);
+        header.rows = static_cast<uint64_t>(rows);
+        header.cols = static_cast<uint64_t>(cols);
+        header.tile = static_cast<uint32_t>(tile);
+        std::memcpy(file.base_, &header, sizeof(header));
+        return file;
+    }
+
+    /**
+     * Open an existing file read-only
+     */
+    static TiledMatrixFile open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open tiled matrix file " + path);
+        }
+        TiledFileHeader header;
+        bool ok = ::pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))
+               && std::equal(TILED_MAGIC, TILED_MAGIC + 8, header.magic);
+        if (!ok || header.elementType != elementTypeCode<T>() || header.elementSize != sizeof(T) || !validShape(header)) {
+            ::close(fd);
+            throw std::runtime_error(path + " is not a tiled " + elementTypeName<T>() + " matrix file.");
+        }
+
+        TiledMatrixFile file(static_cast<int64_t>(header.rows), static_cast<int64_t>(header.cols),
+                             static_cast<int>(header.tile), false);
+        file.fd_ = fd;
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < file.bytes_) {
+            throw std::runtime_error(path + " is truncated.");
+        }
+        file.map(path);
+        return file;
+    }
+
+    TiledMatrixFile(TiledMatrixFile&& other) noexcept
+        : rows_(other.rows_), cols_(other.cols_), tile_(other.tile_), writable_(other.writable_),
+          bytes_(other.bytes_), fd_(other.fd_), base_(other.base_) {
+        other.fd_ = -1;
+        other.base_ = nullptr;
+    }
+    TiledMatrixFile(const TiledMatrixFile&) = delete;
+    TiledMatrixFile& operator=(const TiledMatrixFile&) = delete;
+
+    ~TiledMatrixFile() {
+        if (base_) {
+            if (writable_) {
+                ::msync(base_, bytes_, MS_SYNC);
+            }
+            ::munmap(base_, bytes_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    int64_t rows() const { return rows_; }
+    int64_t cols() const { return cols_; }
+    int tile() const { return tile_; }
+    int64_t tilesDown() const { return (rows_ + tile_ - 1) / tile_; }
+    int64_t tilesAcross() const { return (cols_ + tile_ - 1) / tile_; }
+    size_t fileBytes() const { return bytes_; }
+
+    ConstMatrixView<T> tileView(int64_t ti, int64_t tj) const { return {tileData(ti, tj), tile_, tile_, tile_}; }
+
+    MatrixView<T> tileView(int64_t ti, int64_t tj) {
+        if (!writable_) {
+            throw std::logic_error("Tiled matrix file was opened read-only.");
+        }
+        return {tileData(ti, tj), tile_, tile_, tile_};
+    }
+
+    /**
+     * Element (i, j) of the logical matrix
+     */
+    T at(int64_t i, int64_t j) const {
+        return tileData(i / tile_, j / tile_)[(i % tile_) * tile_ + j % tile_];
+    }
+
+    /**
+     * Ask the kernel to start reading a tile we are about to use
+     */
+    void prefetch(int64_t ti, int64_t tj) const { advise(ti, tj, MADV_WILLNEED); }
+
+    /**
+     * Drop a finished tile from our resident set. Written tiles are scheduled for
+     * writeback first; the data stays in the file (and the page cache) either way.
+     */
+    void evict(int64_t ti, int64_t tj) const {
+        if (writable_) {
+            advise(ti, tj, -1);
+        }
+        advise(ti, tj, MADV_DONTNEED);
+    }
+
+private:
+    TiledMatrixFile(int64_t rows, int64_t cols, int tile, bool writable)
+        : rows_(rows), cols_(cols), tile_(tile), writable_(writable), fd_(-1), base_(nullptr) {
+        bytes_ = TILED_HEADER_BYTES + static_cast<size_t>(tilesDown() * tilesAcross()) * tileBytes();
+    }
+
+    size_t tileBytes() const { return static_cast<size_t>(tile_) * tile_ * sizeof(T); }
+
+    /**
+     * Header dimensions the constructor can use as they are: non-zero, within int
+     * range, and with a total size that fits in size_t
+     */
+    static bool validShape(const TiledFileHeader& header) {
+        const uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int32_t>::max());
+        if (header.rows == 0 || header.cols == 0 || header.tile == 0 || header.rows > limit || header.cols > limit ||
+            header.tile > limit) {
+            return false;
+        }
+        const size_t maxSize = std::numeric_limits<size_t>::max();
+        size_t tile = header.tile;
+        if (tile > maxSize / tile / sizeof(T)) {
+            return false;
+        }
+        size_t tileBytes = tile * tile * sizeof(T);
+        size_t tiles = static_cast<size_t>((header.rows + tile - 1) / tile) *
+                       static_cast<size_t>((header.cols + tile - 1) / tile);
+        return tiles <= (maxSize - TILED_HEADER_BYTES) / tileBytes;
+    }
+
+    T* tileData(int64_t ti, int64_t tj) const {
+        size_t index = static_cast<size_t>(ti * tilesAcross() + tj);
+        return reinterpret_cast<T*>(base_ + TILED_HEADER_BYTES + index * tileBytes());
+    }
+
+    void map(const std::string& path) {
+        int protection = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* base = ::mmap(nullptr, bytes_, protection, MAP_SHARED, fd_, 0);
+        if (base == MAP_FAILED) {
+            throw std::runtime_error("Cannot map tiled matrix file " + path);
+        }
+        base_ = static_cast<char*>(base);
+        // Tiles are walked in file order, so let the kernel read ahead aggressively
+        ::madvise(base_, bytes_, MADV_SEQUENTIAL);
+    }
+
+    // madvise() (or msync() when advice is -1) on the pages covering one tile.
+    // Tiles need not be page aligned, so the range is widened to whole pages;
+    // the mapping is shared, so touching a neighbour's pages never loses data.
+    void advise(int64_t ti, int64_t tj, int advice) const {
+        static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        size_t begin = reinterpret_cast<char*>(tileData(ti, tj)) - base_;
+        size_t end = begin + tileBytes();
+        begin = begin / page * page;
+        end = std::min(bytes_, (end + page - 1) / page * page);
+        if (advice < 0) {
+            ::msync(base_ + begin, end - begin, MS_ASYNC);
+        } else {
+            ::madvise(base_ + begin, end - begin, advice);
+        }
+    }
 
-    // Find the max dimension to determine the necessary padding size
-    int maxDim = std::max({aRows, aCols, bRows, bCols});
-    int paddedSize = nextPowerOfTwo(maxDim);
+    int64_t rows_;
+    int64_t cols_;
+    int tile_;
+    bool writable_;
+    size_t bytes_;
+    int fd_;
+    char* base_;
+};
+
+/**
+ * C = A × B over tiled files, for matrices that do not fit in memory.
+ * Each C tile is finished before moving on: the A tile row and B tile column are
+ * streamed through the blocked kernel one tile pair at a time, with the next pair
+ * prefetched while the current one multiplies. Resident memory is a handful of
+ * tiles (plus two widened tile buffers when T has a wider accumulator),
+ * independent of the matrix sizes.
+ * * @throws std::invalid_argument if the shapes or tile sizes do not line up
+ */
+template <typename T>
+void outOfCoreMultiply(const TiledMatrixFile<T>& A, const TiledMatrixFile<T>& B,
+                       TiledMatrixFile<Accumulator<T>>& C) {
+    using Acc = Accumulator<T>;
 
-    // Pad matrices to be square with size power of 2
-    Matrix paddedA = padMatrix(A, paddedSize);
-    Matrix paddedB = padMatrix(B, paddedSize);
+    if (A.cols() != B.rows() || C.rows() != A.rows() || C.cols() != B.cols()) {
+        throw std::invalid_argument("Invalid tiled matrices: columns of A must equal rows of B, and C must be rows(A) x cols(B).");
+    }
+    if (A.tile() != B.tile() || A.tile() != C.tile()) {
+        throw std::invalid_argument("Tiled matrices must share the same tile size.");
+    }
 
-    // Run the recursive multiplication
-    Matrix result = strassenRecursive(paddedA, paddedB);
+    int tile = A.tile();
+    int64_t tilesK = A.tilesAcross();
 
-    // Extract the actual result (remove padding)
-    return extractMatrix(result, aRows, bCols);
+    // int32 tiles are widened on the fly so the kernel accumulates in int64
+    Matrix<Acc> wideA, wideB;
+    if constexpr (!std::is_same<T, Acc>::value) {
+        wideA = Matrix<Acc>(tile, tile);
+        wideB = Matrix<Acc>(tile, tile);
+    }
+    auto widen = [tile](ConstMatrixView<T> src, Matrix<Acc>& dst) -> ConstMatrixView<Acc> {
+        if constexpr (std::is_same<T, Acc>::value) {
+            return src;
+        } else {
+            size_t count = static_cast<size_t>(tile) * tile;
+            std::transform(src.data, src.data + count, dst.data(), [](const T& x) { return static_cast<Acc>(x); });
+            return dst.view();
+        }
+    };
+
+    for (int64_t i = 0; i < C.tilesDown(); i++) {
+        for (int64_t j = 0; j < C.tilesAcross(); j++) {
+            MatrixView<Acc> c = C.tileView(i, j);
+            A.prefetch(i, 0);
+            B.prefetch(0, j);
+            for (int64_t p = 0; p < tilesK; p++) {
+                if (p + 1 < tilesK) {
+                    A.prefetch(i, p + 1);
+                    B.prefetch(p + 1, j);
+                }
+                blockedMultiply(widen(A.tileView(i, p), wideA), widen(B.tileView(p, j), wideB), c, p > 0);
+                A.evict(i, p);
+                B.evict(p, j);
+            }
+            C.evict(i, j);
+        }
+    }
 }
 
+#endif  // STRASSEN_HAS_MMAP
+
 // ----------------------------------
 // --- IMPLEMENTATION OF HELPERS ---
 // ----------------------------------
 
 /**
- * Standard O(n³) matrix multiplication for base cases
+ * Standard O(n³) matrix multiplication for base cases (C = A × B),
+ * run through the cache-blocked SIMD kernel
+ */
+template <typename T>
+void standardMultiply(InputView<T> A, InputView<T> B, MatrixView<T> C) {
+    blockedMultiply(A, B, C, false);
+}
+
+/**
+ * Standard multiplication returning a freshly allocated result in the accumulator type
+ */
+template <typename T>
+Matrix<Accumulator<T>> standardMultiply(const Matrix<T>& A, const Matrix<T>& B) {
+    using Acc = Accumulator<T>;
+    Matrix<Acc> result(A.rows(), B.cols());
+    if constexpr (std::is_same<T, Acc>::value) {
+        standardMultiply(A.view(), B.view(), result.view());
+    } else {
+        Matrix<Acc> wideA = convertMatrix<Acc>(A);
+        Matrix<Acc> wideB = convertMatrix<Acc>(B);
+        standardMultiply(wideA.view(), wideB.view(), result.view());
+    }
+    return result;
+}
+
+/**
+ * Add two matrices (result = A + B)
+ */
+template <typename T>
+void add(InputView<T> A, InputView<T> B, MatrixView<T> result) {
+    for (int i = 0; i < result.rows; i++) {
+        const T* a = A.row(i);
+        const T* b = B.row(i);
+        T* r = result.row(i);
+        for (int j = 0; j < result.cols; j++) {
+            r[j] = a[j] + b[j];
+        }
+    }
+}
+
+/**
+ * Subtract two matrices (result = A - B)
+ */
+template <typename T>
+void subtract(InputView<T> A, InputView<T> B, MatrixView<T> result) {
+    for (int i = 0; i < result.rows; i++) {
+        const T* a = A.row(i);
+        const T* b = B.row(i);
+        T* r = result.row(i);
+        for (int j = 0; j < result.cols; j++) {
+            r[j] = a[j] - b[j];
+        }
+    }
+}
+
+/**
+ * Copy A into result
+ */
+template <typename T>
+void copyInto(InputView<T> A, MatrixView<T> result) {
+    for (int i = 0; i < result.rows; i++) {
+        std::copy(A.row(i), A.row(i) + result.cols, result.row(i));
+    }
+}
+
+/**
+ * Accumulate A into result (result += A)
+ */
+template <typename T>
+void addInPlace(InputView<T> A, MatrixView<T> result) {
+    for (int i = 0; i < result.rows; i++) {
+        const T* a = A.row(i);
+        T* r = result.row(i);
+        for (int j = 0; j < result.cols; j++) {
+            r[j] += a[j];
+        }
+    }
+}
+
+/**
+ * Subtract A from result (result -= A)
+ */
+template <typename T>
+void subtractInPlace(InputView<T> A, MatrixView<T> result) {
+    for (int i = 0; i < result.rows; i++) {
+        const T* a = A.row(i);
+        T* r = result.row(i);
+        for (int j = 0; j < result.cols; j++) {
+            r[j] -= a[j];
+        }
+    }
+}
+
+/**
+ * View a submatrix of the given matrix (shares storage, no copy)
+ */
+template <typename T>
+ConstMatrixView<T> getSubMatrix(ConstMatrixView<T> matrix, int rowStart, int colStart, int rows, int cols) {
+    return matrix.block(rowStart, colStart, rows, cols);
+}
+
+template <typename T>
+MatrixView<T> getSubMatrix(MatrixView<T> matrix, int rowStart, int colStart, int rows, int cols) {
+    return matrix.block(rowStart, colStart, rows, cols);
+}
+
+/**
+ * Check if two matrices can be multiplied (A[rows1][cols1] * B[rows2][cols2] => cols1 == rows2)
+ */
+template <typename T>
+bool isValidForMultiplication(const Matrix<T>& A, const Matrix<T>& B) {
+    if (A.empty() || B.empty()) {
+        return false;
+    }
+
+    return A.cols() == B.rows();
+}
+
+// -----------------------------------
+// --- DEMONSTRATION & IO METHODS ---
+// -----------------------------------
+
+/**
+ * Print a matrix in a formatted way
  */
-Matrix standardMultiply(const Matrix& A, const Matrix& B) {
-    int rows = A.size();
-    int cols = B[0].size();
-    int common = B.size();
+template <typename T>
+void printMatrix(const Matrix<T>& matrix, const std::string& name) {
+    std::cout << "\n" << name << ":" << std::endl;
+
+    if (matrix.empty()) {
+        std::cout << "Matrix is empty." << std::endl;
+        return;
+    }
+
+    int rows = matrix.rows();
+    int cols = matrix.cols();
 
-    Matrix result(rows, std::vector<int>(cols, 0));
+    if (rows > 10 || cols > 10) {
+        std::cout << "Matrix is too large to display (" << rows << "x" << cols << ")" << std::endl;
+        return;
+    }
 
     for (int i = 0; i < rows; i++) {
         for (int j = 0; j < cols; j++) {
-            for (int k = 0; k < common; k++) {
-                result[i][j] += A[i][k] * B[k][j];
-            }
+            std::cout << std::setw(8) << matrix(i, j) << " ";
         }
+        std::cout << std::endl;
     }
-
-    return result;
 }
 
 /**
- * Add two matrices (A + B)
+ * Generate a random matrix for testing
  */
-Matrix add(const Matrix& A, const Matrix& B) {
-    int n = A.size();
-    Matrix result(n, std::vector<int>(n));
+template <typename T>
+Matrix<T> generateRandomMatrix(int rows, int cols, int maxValue) {
+    Matrix<T> matrix(rows, cols);
+    // Use std::srand and std::rand for basic random numbers in C++
+    // std::srand(std::time(0)); (usually called once in main)
 
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            result[i][j] = A[i][j] + B[i][j];
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            // Generates a value between -maxValue and +maxValue
+            matrix(i, j) = static_cast<T>((std::rand() % (2 * maxValue + 1)) - maxValue);
         }
     }
 
-    return result;
+    return matrix;
 }
 
 /**
- * Subtract two matrices (A - B)
+ * Compare two matrices for equality. Integer and modular results must match
+ * exactly; floating-point results may differ by rounding, so they are compared
+ * against a tolerance relative to the largest entry.
  */
-Matrix subtract(const Matrix& A, const Matrix& B) {
-    int n = A.size();
-    Matrix result(n, std::vector<int>(n));
-
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            result[i][j] = A[i][j] - B[i][j];
+template <typename T>
+bool matricesEqual(const Matrix<T>& A, const Matrix<T>& B) {
+    if constexpr (std::is_floating_point<T>::value) {
+        if (A.rows() != B.rows() || A.cols() != B.cols()) {
+            return false;
+        }
+        size_t count = static_cast<size_t>(A.rows()) * A.cols();
+        double largest = 0;
+        double maxDiff = 0;
+        for (size_t i = 0; i < count; i++) {
+            largest = std::max(largest, std::fabs(static_cast<double>(A.data()[i])));
+            maxDiff = std::max(maxDiff, std::fabs(static_cast<double>(A.data()[i]) - B.data()[i]));
         }
+        double tolerance = 1e3 * std::numeric_limits<T>::epsilon() * std::max(largest, 1.0);
+        return maxDiff <= tolerance;
+    } else {
+        return A == B;
     }
-
-    return result;
 }
 
+// -----------------------------------
+// --- MATRIX FILE IO ---
+// -----------------------------------
+
 /**
- * Extract a submatrix from the given matrix
+ * Header of a binary matrix file, followed by rows x cols elements in row-major order.
+ * Fields are fixed-width and stored in the writing machine's byte order.
  */
-Matrix getSubMatrix(const Matrix& matrix, int rowStart, int colStart, int size) {
-    Matrix subMatrix(size, std::vector<int>(size));
-
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            subMatrix[i][j] = matrix[rowStart + i][colStart + j];
-        }
-    }
+struct MatrixFileHeader {
+    char magic[8];         // "STRMATX1"
+    uint32_t elementType;  // elementTypeCode<T>()
+    uint32_t elementSize;  // sizeof(T)
+    uint64_t rows;
+    uint64_t cols;
+};
 
-    return subMatrix;
-}
+const char MATRIX_MAGIC[8] = {'S', 'T', 'R', 'M', 'A', 'T', 'X', '1'};
 
 /**
- * Combine four quadrant matrices into one matrix
+ * Whole file mapped read-only (or read into memory where mmap is unavailable)
  */
-Matrix combineMatrices(const Matrix& C11, const Matrix& C12, const Matrix& C21, const Matrix& C22) {
-    int half = C11.size();
-    int n = 2 * half;
-    Matrix result(n, std::vector<int>(n));
-
-    // Copy C11 (Top-Left)
-    for (int i = 0; i < half; i++) {
-        std::copy(C11[i].begin(), C11[i].end(), result[i].begin());
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) : data_(nullptr), size_(0) {
+#if STRASSEN_HAS_MMAP
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        struct stat info;
+        // The destructor does not run if the constructor throws, so close fd_ here
+        if (fd_ < 0 || ::fstat(fd_, &info) != 0) {
+            if (fd_ >= 0) {
+                ::close(fd_);
+            }
+            throw std::runtime_error("Cannot open " + path);
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ > 0) {
+            void* base = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (base == MAP_FAILED) {
+                ::close(fd_);
+                throw std::runtime_error("Cannot map " + path);
+            }
+            data_ = static_cast<const char*>(base);
+            ::madvise(base, size_, MADV_SEQUENTIAL);
+        }
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
     }
 
-    // Copy C12 (Top-Right)
-    for (int i = 0; i < half; i++) {
-        std::copy(C12[i].begin(), C12[i].end(), result[i].begin() + half);
-    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
 
-    // Copy C21 (Bottom-Left)
-    for (int i = 0; i < half; i++) {
-        std::copy(C21[i].begin(), C21[i].end(), result[i + half].begin());
+    ~MappedFile() {
+#if STRASSEN_HAS_MMAP
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+#endif
     }
 
-    // Copy C22 (Bottom-Right)
-    for (int i = 0; i < half; i++) {
-        std::copy(C22[i].begin(), C22[i].end(), result[i + half].begin() + half);
-    }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
 
-    return result;
-}
+private:
+    const char* data_;
+    size_t size_;
+#if STRASSEN_HAS_MMAP
+    int fd_;
+#else
+    std::vector<char> buffer_;
+#endif
+};
 
 /**
- * Pad matrix to make it square with size being power of 2,
- * filling new spaces with zeros.
+ * Hand-rolled number scanner over a character range. Values may be separated by
+ * any whitespace or commas. Integers are parsed digit by digit without locale or
+ * stream state, which is where formatted extraction spends most of its time;
+ * floating-point values go through std::from_chars.
  */
-Matrix padMatrix(const Matrix& matrix, int newSize) {
-    int rows = matrix.size();
-    int cols = matrix[0].size();
+class NumberScanner {
+public:
+    NumberScanner(const char* begin, const char* end) : p_(begin), end_(end), token_(begin) {}
+
+    /**
+     * Parse the next value into out. Returns false at the end of the input.
+     * @throws std::runtime_error on a malformed or out-of-range value
+     */
+    template <typename T>
+    bool next(T& out) {
+        skipSeparators();
+        if (p_ == end_) {
+            return false;
+        }
+        token_ = p_;
+        if constexpr (std::is_floating_point<T>::value) {
+            const char* start = p_ + (*p_ == '+' ? 1 : 0);
+            std::from_chars_result parsed = std::from_chars(start, end_, out);
+            if (parsed.ec != std::errc()) {
+                fail();
+            }
+            p_ = parsed.ptr;
+        } else if constexpr (IsModInt<T>::value) {
+            out = T(nextInteger(std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max()));
+        } else {
+            out = static_cast<T>(nextInteger(std::numeric_limits<T>::min(), std::numeric_limits<T>::max()));
+        }
+        if (p_ != end_ && !isSeparator(*p_)) {
+            fail();
+        }
+        return true;
+    }
 
-    // Initialize with zeros
-    Matrix padded(newSize, std::vector<int>(newSize, 0)); 
+private:
+    static bool isSeparator(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == ',';
+    }
 
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            padded[i][j] = matrix[i][j];
+    void skipSeparators() {
+        while (p_ != end_ && isSeparator(*p_)) {
+            ++p_;
         }
     }
 
-    return padded;
-}
-
-/**
- * Extract the actual result matrix (remove padding)
- */
-Matrix extractMatrix(const Matrix& matrix, int rows, int cols) {
-    Matrix result(rows, std::vector<int>(cols));
+    long long nextInteger(long long lowest, long long highest) {
+        bool negative = *p_ == '-';
+        if (*p_ == '-' || *p_ == '+') {
+            ++p_;
+        }
+        const char* digits = p_;
+        unsigned long long value = 0;
+        const unsigned long long limit = negative ? static_cast<unsigned long long>(-(lowest + 1)) + 1
+                                                  : static_cast<unsigned long long>(highest);
+        while (p_ != end_ && *p_ >= '0' && *p_ <= '9') {
+            unsigned digit = static_cast<unsigned>(*p_ - '0');
+            if (value > (limit - digit) / 10) {
+                fail();
+            }
+            value = value * 10 + digit;
+            ++p_;
+        }
+        if (p_ == digits) {
+            fail();
+        }
+        return negative ? static_cast<long long>(0 - value) : static_cast<long long>(value);
+    }
 
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            result[i][j] = matrix[i][j];
+    [[noreturn]] void fail() const {
+        const char* stop = token_;
+        while (stop != end_ && !isSeparator(*stop) && stop - token_ < 32) {
+            ++stop;
         }
+        throw std::runtime_error("Invalid or out-of-range number \"" + std::string(token_, stop) + "\"");
     }
 
-    return result;
-}
+    const char* p_;
+    const char* end_;
+    const char* token_;  // start of the value being parsed, for error messages
+};
 
 /**
- * Find the next power of 2 greater than or equal to n
+ * Pulls numbers from a stream one line at a time through NumberScanner,
+ * for interactive input where the whole stream cannot be mapped up front
  */
-int nextPowerOfTwo(int n) {
-    if (n <= 1) return 1;
-
-    int power = 1;
-    // Check if n is already a power of two
-    if ((n & (n - 1)) == 0) return n;
-
-    // Use bit manipulation (more efficient) to find the next power of two
-    while (power < n) {
-        power <<= 1; // equivalent to power *= 2;
+class StreamScanner {
+public:
+    explicit StreamScanner(std::istream& in) : in_(in), scanner_(nullptr, nullptr) {}
+
+    template <typename T>
+    bool next(T& out) {
+        while (!scanner_.next(out)) {
+            if (!std::getline(in_, line_)) {
+                return false;
+            }
+            scanner_ = NumberScanner(line_.data(), line_.data() + line_.size());
+        }
+        return true;
     }
 
-    return power;
-    // An alternative way:
-    // int power = 1;
-    // while (power < n) power <<= 1;
-    // return power;
-}
+private:
+    std::istream& in_;
+    std::string line_;
+    NumberScanner scanner_;
+};
 
 /**
- * Check if two matrices can be multiplied (A[rows1][cols1] * B[rows2][cols2] => cols1 == rows2)
+ * Fill every element of matrix, row by row, from a scanner
+ * @throws std::runtime_error if the input runs out first
  */
-bool isValidForMultiplication(const Matrix& A, const Matrix& B) {
-    if (A.empty() || B.empty() || A[0].empty() || B[0].empty()) {
-        return false;
+template <typename T, typename Scanner>
+void scanMatrixValues(Scanner& scanner, Matrix<T>& matrix, const std::string& source) {
+    T* data = matrix.data();
+    size_t count = static_cast<size_t>(matrix.rows()) * matrix.cols();
+    for (size_t i = 0; i < count; i++) {
+        if (!scanner.next(data[i])) {
+            throw std::runtime_error(source + ": expected " + std::to_string(count) + " values, found " + std::to_string(i));
+        }
     }
-
-    return A[0].size() == B.size();
 }
 
-// -----------------------------------
-// --- DEMONSTRATION & IO METHODS ---
-// -----------------------------------
-
 /**
- * Print a matrix in a formatted way
+ * Load a matrix file. Binary files (starting with the STRMATX1 magic) are copied
+ * straight out of the mapping; anything else is parsed as text: "rows cols"
+ * followed by the elements in row-major order.
+ * @throws std::runtime_error if the file cannot be read or does not hold a T matrix
  */
-void printMatrix(const Matrix& matrix, const std::string& name) {
-    std::cout << "\n" << name << ":" << std::endl;
-
-    if (matrix.empty() || matrix[0].empty()) {
-        std::cout << "Matrix is empty." << std::endl;
-        return;
-    }
-
-    int rows = matrix.size();
-    int cols = matrix[0].size();
-
-    if (rows > 10 || cols > 10) {
-        std::cout << "Matrix is too large to display (" << rows << "x" << cols << ")" << std::endl;
-        return;
+template <typename T>
+Matrix<T> loadMatrix(const std::string& path) {
+    MappedFile file(path);
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+
+    if (file.size() >= sizeof(MatrixFileHeader) && std::equal(MATRIX_MAGIC, MATRIX_MAGIC + 8, begin)) {
+        MatrixFileHeader header;
+        std::memcpy(&header, begin, sizeof(header));
+        if (header.elementType != elementTypeCode<T>() || header.elementSize != sizeof(T)) {
+            throw std::runtime_error(path + " does not hold a " + elementTypeName<T>() + " matrix.");
+        }
+        if (header.rows == 0 || header.cols == 0 || header.rows > INT32_MAX || header.cols > INT32_MAX
+            || header.rows * header.cols > (file.size() - sizeof(header)) / sizeof(T)) {
+            throw std::runtime_error(path + " has an invalid size.");
+        }
+        Matrix<T> matrix(static_cast<int>(header.rows), static_cast<int>(header.cols));
+        std::memcpy(matrix.data(), begin + sizeof(header), header.rows * header.cols * sizeof(T));
+        return matrix;
     }
 
-    for (const auto& row : matrix) {
-        for (int val : row) {
-            std::cout << std::setw(8) << val << " ";
-        }
-        std::cout << std::endl;
+    NumberScanner scanner(begin, end);
+    int rows = 0;
+    int cols = 0;
+    if (!scanner.next(rows) || !scanner.next(cols) || rows <= 0 || cols <= 0) {
+        throw std::runtime_error(path + ": expected \"rows cols\" before the elements.");
     }
+    Matrix<T> matrix(rows, cols);
+    scanMatrixValues(scanner, matrix, path);
+    return matrix;
 }
 
 /**
- * Generate a random matrix for testing
+ * Write one value as text into out (at least 32 bytes free); returns the characters written
  */
-Matrix generateRandomMatrix(int rows, int cols, int maxValue) {
-    Matrix matrix(rows, std::vector<int>(cols));
-    // Use std::srand and std::rand for basic random numbers in C++
-    // std::srand(std::time(0)); (usually called once in main)
-
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            // Generates a value between -maxValue and +maxValue
-            matrix[i][j] = (std::rand() % (2 * maxValue + 1)) - maxValue;
-        }
+template <typename T>
+size_t formatValue(char* out, T value) {
+    if constexpr (IsModInt<T>::value) {
+        return std::to_chars(out, out + 32, value.value).ptr - out;
+    } else {
+        // Floating-point values use the shortest form that reads back exactly
+        return std::to_chars(out, out + 32, value).ptr - out;
     }
-
-    return matrix;
 }
 
 /**
- * Compare two matrices for equality
+ * Save a matrix: binary (see MatrixFileHeader) when the path ends in ".bin",
+ * otherwise text in the format loadMatrix reads. Text is formatted into a large
+ * buffer with std::to_chars and written in big chunks.
+ * @throws std::runtime_error if the file cannot be written
  */
-bool matricesEqual(const Matrix& A, const Matrix& B) {
-    if (A.size() != B.size() || A[0].size() != B[0].size()) {
-        return false;
+template <typename T>
+void saveMatrix(const Matrix<T>& matrix, const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot write " + path);
     }
 
-    for (size_t i = 0; i < A.size(); i++) {
-        for (size_t j = 0; j < A[0].size(); j++) {
-            if (A[i][j] != B[i][j]) {
-                return false;
+    bool binary = path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+    if (binary) {
+        MatrixFileHeader header = {};
+        std::copy(MATRIX_MAGIC, MATRIX_MAGIC + 8, header.magic);
+        header.elementType = elementTypeCode<T>();
+        header.elementSize = sizeof(T);
+        header.rows = static_cast<uint64_t>(matrix.rows());
+        header.cols = static_cast<uint64_t>(matrix.cols());
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(matrix.data()),
+                  static_cast<std::streamsize>(static_cast<size_t>(matrix.rows()) * matrix.cols() * sizeof(T)));
+    } else {
+        std::vector<char> buffer(1 << 20);
+        size_t used = 0;
+        auto flush = [&] {
+            out.write(buffer.data(), static_cast<std::streamsize>(used));
+            used = 0;
+        };
+
+        used += std::sprintf(buffer.data(), "%d %d\n", matrix.rows(), matrix.cols());
+        for (int i = 0; i < matrix.rows(); i++) {
+            for (int j = 0; j < matrix.cols(); j++) {
+                if (buffer.size() - used < 64) {
+                    flush();
+                }
+                used += formatValue(buffer.data() + used, matrix(i, j));
+                buffer[used++] = j + 1 < matrix.cols() ? ' ' : '\n';
             }
         }
+        flush();
     }
 
-    return true;
+    if (!out) {
+        throw std::runtime_error("Error while writing " + path);
+    }
 }
 
-void handleManualInput() {
+template <typename T>
+void handleFileMultiply(const StrassenOptions& options) {
+    std::string pathA, pathB, pathC;
+
+    std::cout << "Enter path of matrix A: ";
+    std::cin >> pathA;
+    std::cout << "Enter path of matrix B: ";
+    std::cin >> pathB;
+    std::cout << "Enter output path for A x B (\".bin\" for binary, anything else for text): ";
+    std::cin >> pathC;
+
+    auto start = std::chrono::steady_clock::now();
+    auto lap = [&start] {
+        auto now = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(now - start).count();
+        start = now;
+        return ms;
+    };
+
+    Matrix<T> A = loadMatrix<T>(pathA);
+    Matrix<T> B = loadMatrix<T>(pathB);
+    double loadMs = lap();
+
+    auto result = strassenMultiply(A, B, options);
+    double multiplyMs = lap();
+
+    saveMatrix(result, pathC);
+    double saveMs = lap();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Multiplied " << A.rows() << " x " << A.cols() << " by " << B.rows() << " x " << B.cols()
+              << ", result written to " << pathC << std::endl;
+    std::cout << "Load: " << loadMs << " ms, multiply: " << multiplyMs << " ms, save: " << saveMs << " ms" << std::endl;
+}
+
+template <typename T>
+void handleManualInput(const StrassenOptions& options) {
     int rows1, cols1, rows2, cols2;
 
     std::cout << "Enter rows of first matrix: ";
@@ -384,26 +2612,21 @@ void handleManualInput() {
         return;
     }
 
-    Matrix A(rows1, std::vector<int>(cols1));
-    Matrix B(rows2, std::vector<int>(cols2));
+    Matrix<T> A(rows1, cols1);
+    Matrix<T> B(rows2, cols2);
+
+    // Elements are scanned a line at a time instead of one formatted extraction each
+    StreamScanner scanner(std::cin);
 
     std::cout << "Enter elements of first matrix (row by row):" << std::endl;
-    for (int i = 0; i < rows1; i++) {
-        for (int j = 0; j < cols1; j++) {
-            std::cin >> A[i][j];
-        }
-    }
+    scanMatrixValues(scanner, A, "Matrix A");
 
     std::cout << "Enter elements of second matrix (row by row):" << std::endl;
-    for (int i = 0; i < rows2; i++) {
-        for (int j = 0; j < cols2; j++) {
-            std::cin >> B[i][j];
-        }
-    }
+    scanMatrixValues(scanner, B, "Matrix B");
 
-    std::clock_t startTime = std::clock();
-    Matrix result = strassenMultiply(A, B);
-    double duration = (std::clock() - startTime) / (double) CLOCKS_PER_SEC * 1000.0; // convert to ms
+    auto startTime = std::chrono::steady_clock::now();
+    auto result = strassenMultiply(A, B, options);
+    double duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
 
     printMatrix(A, "Matrix A");
     printMatrix(B, "Matrix B");
@@ -412,7 +2635,8 @@ void handleManualInput() {
     std::cout << "\nTime taken: " << duration << " ms" << std::endl;
 }
 
-void handleRandomMatrices() {
+template <typename T>
+void handleRandomMatrices(const StrassenOptions& options) {
     int n, maxValue;
 
     std::cout << "Enter matrix size (n for n x n matrices): ";
@@ -420,19 +2644,21 @@ void handleRandomMatrices() {
     std::cout << "Enter maximum value for random elements: ";
     std::cin >> maxValue;
 
-    Matrix A = generateRandomMatrix(n, n, maxValue);
-    Matrix B = generateRandomMatrix(n, n, maxValue);
+    Matrix<T> A = generateRandomMatrix<T>(n, n, maxValue);
+    Matrix<T> B = generateRandomMatrix<T>(n, n, maxValue);
 
     std::cout << "Generated random " << n << " x " << n << " matrices" << std::endl;
+    std::cout << "Estimated peak memory for the multiply: " << std::fixed << std::setprecision(2)
+              << strassenPeakBytes<T>(n, n, n, options) / (1024.0 * 1024.0) << " MiB" << std::endl;
 
     if (n <= 10) {
         printMatrix(A, "Matrix A");
         printMatrix(B, "Matrix B");
     }
 
-    std::clock_t startTime = std::clock();
-    Matrix result = strassenMultiply(A, B);
-    double duration = (std::clock() - startTime) / (double) CLOCKS_PER_SEC * 1000.0; // convert to ms
+    auto startTime = std::chrono::steady_clock::now();
+    auto result = strassenMultiply(A, B, options);
+    double duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
 
     if (n <= 10) {
         printMatrix(result, "Result (A x B)");
@@ -441,88 +2667,681 @@ void handleRandomMatrices() {
     std::cout << "Time taken: " << duration << " ms" << std::endl;
 }
 
-void performanceComparison() {
+#if STRASSEN_HAS_MMAP
+
+/**
+ * Fill a tiled file with random values one tile at a time, so generating an input
+ * larger than memory stays within the same resident bound as the multiply
+ */
+template <typename T>
+void fillRandomTiled(TiledMatrixFile<T>& file, int maxValue) {
+    int tile = file.tile();
+    for (int64_t ti = 0; ti < file.tilesDown(); ti++) {
+        for (int64_t tj = 0; tj < file.tilesAcross(); tj++) {
+            MatrixView<T> block = file.tileView(ti, tj);
+            int rows = static_cast<int>(std::min<int64_t>(tile, file.rows() - ti * tile));
+            int cols = static_cast<int>(std::min<int64_t>(tile, file.cols() - tj * tile));
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j < cols; j++) {
+                    block(i, j) = static_cast<T>((std::rand() % (2 * maxValue + 1)) - maxValue);
+                }
+            }
+            file.evict(ti, tj);
+        }
+    }
+}
+
+/**
+ * Peak resident set size of this process in MiB
+ */
+double peakResidentMiB() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);  // bytes on macOS
+#else
+    return usage.ru_maxrss / 1024.0;             // KiB on Linux
+#endif
+}
+
+template <typename T>
+void handleOutOfCore() {
+    using Acc = Accumulator<T>;
+    std::string prefix;
+
+    std::cout << "Enter file prefix for the tiled matrices: ";
+    std::cin >> prefix;
+    std::string pathA = prefix + "_A.tiles";
+    std::string pathB = prefix + "_B.tiles";
+    std::string pathC = prefix + "_C.tiles";
+
+    if (std::ifstream(pathA) && std::ifstream(pathB)) {
+        std::cout << "Using existing " << pathA << " and " << pathB << std::endl;
+    } else {
+        int64_t m, k, n;
+        int tile;
+        std::cout << "Enter dimensions m k n (A is m x k, B is k x n): ";
+        std::cin >> m >> k >> n;
+        std::cout << "Enter tile size (e.g. 1024): ";
+        std::cin >> tile;
+
+        TiledMatrixFile<T> A = TiledMatrixFile<T>::create(pathA, m, k, tile);
+        fillRandomTiled(A, 100);
+        TiledMatrixFile<T> B = TiledMatrixFile<T>::create(pathB, k, n, tile);
+        fillRandomTiled(B, 100);
+        std::cout << "Generated random " << pathA << " and " << pathB << std::endl;
+    }
+
+    TiledMatrixFile<T> A = TiledMatrixFile<T>::open(pathA);
+    TiledMatrixFile<T> B = TiledMatrixFile<T>::open(pathB);
+    TiledMatrixFile<Acc> C = TiledMatrixFile<Acc>::create(pathC, A.rows(), B.cols(), A.tile());
+
+    std::cout << "Multiplying " << A.rows() << " x " << A.cols() << " by " << B.rows() << " x " << B.cols()
+              << " in " << A.tile() << " x " << A.tile() << " tiles" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    outOfCoreMultiply(A, B, C);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double fileMiB = (A.fileBytes() + B.fileBytes() + C.fileBytes()) / (1024.0 * 1024.0);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Result written to " << pathC << std::endl;
+    std::cout << "Time taken: " << seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Tiled files: " << fileMiB << " MiB, peak resident: " << peakResidentMiB() << " MiB" << std::endl;
+
+    // Spot-check a few entries against direct dot products read from the files
+    const int samples = 16;
+    Matrix<Acc> expected(1, samples);
+    Matrix<Acc> actual(1, samples);
+    for (int s = 0; s < samples; s++) {
+        int64_t i = std::rand() % A.rows();
+        int64_t j = std::rand() % B.cols();
+        Acc sum = Acc();
+        for (int64_t p = 0; p < A.cols(); p++) {
+            sum += static_cast<Acc>(A.at(i, p)) * static_cast<Acc>(B.at(p, j));
+        }
+        expected(0, s) = sum;
+        actual(0, s) = C.at(i, j);
+    }
+    std::cout << "Spot check (" << samples << " entries): " << (matricesEqual(actual, expected) ? "passed" : "FAILED")
+              << std::endl;
+}
+
+#endif  // STRASSEN_HAS_MMAP
+
+// -----------------------------------
+// --- THRESHOLD AUTOTUNING ---
+// -----------------------------------
+
+/**
+ * Load tuned settings from a "key=value" file ('#' starts a comment).
+ * Returns false (and leaves the defaults alone) if the file is missing or has no valid threshold.
+ */
+bool loadTuningConfig(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t eq = line.find('=');
+        if (line.empty() || line[0] == '#' || eq == std::string::npos) {
+            continue;
+        }
+        if (line.substr(0, eq) == "threshold") {
+            int value = std::atoi(line.c_str() + eq + 1);
+            if (value > 0) {
+                tunedThreshold() = value;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool saveTuningConfig(const std::string& path, int threshold, int sampleSize, const std::string& tunedOn) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << "# Strassen crossover tuned on this machine (" << sampleSize << " x " << sampleSize
+        << " sample, " << tunedOn << ")" << std::endl;
+    out << "threshold=" << threshold << std::endl;
+    return static_cast<bool>(out);
+}
+
+/**
+ * Sweep candidate thresholds on an n x n multiply and return the fastest.
+ * Each candidate keeps its best of several wall-clock runs to filter out noise.
+ */
+template <typename T>
+int autotuneThreshold(const StrassenOptions& options, int n) {
+    const int candidates[] = {16, 32, 64, 128, 256, 512};
+    const int runs = 3;
+
+    Matrix<T> A = generateRandomMatrix<T>(n, n, 100);
+    Matrix<T> B = generateRandomMatrix<T>(n, n, 100);
+
+    int best = DEFAULT_THRESHOLD;
+    double bestTime = 0;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(10) << "Threshold" << std::setw(14) << "Best (ms)" << std::endl;
+
+    for (int threshold : candidates) {
+        if (threshold >= n) {
+            break;
+        }
+        StrassenOptions run = options;
+        run.threshold = threshold;
+
+        double fastest = 0;
+        for (int r = 0; r < runs; r++) {
+            auto start = std::chrono::steady_clock::now();
+            auto result = strassenMultiply(A, B, run);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (r == 0 || ms < fastest) {
+                fastest = ms;
+            }
+        }
+
+        std::cout << std::setw(10) << threshold << std::setw(14) << fastest << std::endl;
+        if (bestTime == 0 || fastest < bestTime) {
+            bestTime = fastest;
+            best = threshold;
+        }
+    }
+
+    return best;
+}
+
+template <typename T>
+void handleAutotune(const StrassenOptions& options, const std::string& configPath) {
+    int n;
+    std::cout << "Enter sample matrix size for tuning (e.g. 1024): ";
+    std::cin >> n;
+    if (n < 2) {
+        throw std::invalid_argument("Sample size must be at least 2.");
+    }
+
+    std::cout << "\n=== Autotuning Strassen threshold on " << n << " x " << n << " ===" << std::endl;
+    int best = autotuneThreshold<T>(options, n);
+    tunedThreshold() = best;
+
+    std::cout << "Best threshold: " << best << std::endl;
+    std::string tunedOn = std::string(elementTypeName<T>()) + ", leaf kernel " + leafKernel<Accumulator<T>>().name;
+    if (saveTuningConfig(configPath, best, n, tunedOn)) {
+        std::cout << "Saved to " << configPath << std::endl;
+    } else {
+        std::cerr << "Could not write " << configPath << std::endl;
+    }
+}
+
+// -----------------------------------
+// --- BENCHMARK HARNESS ---
+// -----------------------------------
+
+/**
+ * What the benchmark runs and where it writes its results
+ */
+struct BenchmarkConfig {
+    std::vector<int> sizes = {64, 128, 256, 512};
+    int warmups = 1;           // untimed runs per size, to warm caches and the thread pool
+    int trials = 5;            // timed runs per size
+    unsigned seed = 12345;     // fixed so that every run multiplies the same matrices
+    bool scaling = true;       // also print the strong-scaling table
+    std::string csvPath;       // empty = no CSV export
+    std::string jsonPath;      // empty = no JSON export
+};
+
+/**
+ * Wall-clock statistics over the timed trials of one benchmark case
+ */
+struct TimingStats {
+    double minMs;
+    double medianMs;
+    double p95Ms;
+};
+
+/**
+ * Run fn warmups times untimed, then trials times under a steady wall clock.
+ * The percentiles use the nearest-rank method.
+ */
+template <typename Fn>
+TimingStats timeTrials(Fn&& fn, int warmups, int trials) {
+    for (int i = 0; i < warmups; i++) {
+        fn();
+    }
+
+    std::vector<double> times;
+    for (int i = 0; i < std::max(1, trials); i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+
+    auto percentile = [&](double q) {
+        size_t rank = static_cast<size_t>(std::ceil(q * times.size()));
+        return times[std::max<size_t>(rank, 1) - 1];
+    };
+    return {times.front(), percentile(0.5), percentile(0.95)};
+}
+
+/**
+ * One row of benchmark output
+ */
+struct BenchmarkResult {
+    std::string algorithm;
+    int size;
+    int threads;
+    TimingStats stats;
+    double gflops;  // 2 n³ / median time
+    bool matches;   // result agreed with the standard multiply
+};
+
+/**
+ * Parse a comma-separated list of positive sizes, e.g. "64,128,1000"
+ */
+bool parseSizeList(const std::string& text, std::vector<int>& sizes) {
+    std::vector<int> parsed;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        std::string item = text.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        int value = std::atoi(item.c_str());
+        if (value <= 0) {
+            return false;
+        }
+        parsed.push_back(value);
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    sizes = parsed;
+    return !sizes.empty();
+}
+
+template <typename T>
+void writeBenchmarkCsv(const std::string& path, const std::vector<BenchmarkResult>& results,
+                       const StrassenOptions& options, const BenchmarkConfig& config) {
+    std::ofstream out(path);
+    out << "algorithm,element_type,size,threads,threshold,schedule,leaf_kernel,warmups,trials,seed,"
+        << "min_ms,median_ms,p95_ms,gflops,matches\n";
+    for (const BenchmarkResult& r : results) {
+        out << r.algorithm << ",\"" << elementTypeName<T>() << "\"," << r.size << "," << r.threads << ","
+            << effectiveThreshold(options) << "," << scheduleName(options.schedule) << ","
+            << leafKernel<Accumulator<T>>().name << "," << config.warmups << "," << config.trials << ","
+            << config.seed << "," << r.stats.minMs << "," << r.stats.medianMs << "," << r.stats.p95Ms << ","
+            << r.gflops << "," << (r.matches ? "true" : "false") << "\n";
+    }
+    std::cout << (out ? "Wrote " : "Could not write ") << path << std::endl;
+}
+
+template <typename T>
+void writeBenchmarkJson(const std::string& path, const std::vector<BenchmarkResult>& results,
+                        const StrassenOptions& options, const BenchmarkConfig& config) {
+    std::ofstream out(path);
+    out << "{\n";
+    out << "  \"element_type\": \"" << elementTypeName<T>() << "\",\n";
+    out << "  \"leaf_kernel\": \"" << leafKernel<Accumulator<T>>().name << "\",\n";
+    out << "  \"threshold\": " << effectiveThreshold(options) << ",\n";
+    out << "  \"schedule\": \"" << scheduleName(options.schedule) << "\",\n";
+    out << "  \"parallel_depth\": " << options.parallelDepth << ",\n";
+    out << "  \"warmups\": " << config.warmups << ",\n";
+    out << "  \"trials\": " << config.trials << ",\n";
+    out << "  \"seed\": " << config.seed << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& r = results[i];
+        out << "    {\"algorithm\": \"" << r.algorithm << "\", \"size\": " << r.size << ", \"threads\": " << r.threads
+            << ", \"min_ms\": " << r.stats.minMs << ", \"median_ms\": " << r.stats.medianMs
+            << ", \"p95_ms\": " << r.stats.p95Ms << ", \"gflops\": " << r.gflops
+            << ", \"matches\": " << (r.matches ? "true" : "false") << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    std::cout << (out ? "Wrote " : "Could not write ") << path << std::endl;
+}
+
+double gflopsFor(int n, double ms) {
+    return ms > 0 ? 2.0 * n * n * n / (ms * 1e6) : 0;
+}
+
+/**
+ * Strong-scaling table for one large multiply: median wall-clock time, speedup and
+ * parallel efficiency (speedup / threads) from 1 thread up to the requested count.
+ */
+template <typename T>
+void scalingReport(const StrassenOptions& options, const BenchmarkConfig& config,
+                   std::vector<BenchmarkResult>& results) {
+    int maxThreads = options.threads > 1 ? options.threads
+                                         : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int n = 1024;
+
+    std::cout << "\n=== Scaling: " << n << " x " << n << " Strassen, 1 to " << maxThreads << " threads ===" << std::endl;
+
+    Matrix<T> A = generateRandomMatrix<T>(n, n, 100);
+    Matrix<T> B = generateRandomMatrix<T>(n, n, 100);
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double baseline = 0;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(8) << "Threads" << std::setw(14) << "Median (ms)" << std::setw(12) << "Speedup"
+              << std::setw(14) << "Efficiency" << std::endl;
+
+    for (int t : threadCounts) {
+        StrassenOptions run = options;
+        run.threads = t;
+
+        TimingStats stats = timeTrials([&] { strassenMultiply(A, B, run); }, config.warmups, config.trials);
+        double ms = stats.medianMs;
+        results.push_back({"strassen-scaling", n, t, stats, gflopsFor(n, ms), true});
+
+        if (t == 1) {
+            baseline = ms;
+        }
+        double speedup = baseline / ms;
+        std::cout << std::setw(8) << t << std::setw(14) << ms << std::setw(11) << speedup << "x"
+                  << std::setw(13) << 100.0 * speedup / t << "%" << std::endl;
+    }
+}
+
+/**
+ * Strassen vs the standard blocked multiply over the configured sizes, with warmups,
+ * repeated wall-clock trials and min/median/p95 per case, optionally exported as CSV/JSON
+ */
+template <typename T>
+void performanceComparison(const StrassenOptions& options, const BenchmarkConfig& config) {
     std::cout << "\n=== Performance Comparison: Strassen vs Standard ===" << std::endl;
+    std::cout << "Element type: " << elementTypeName<T>() << std::endl;
+    std::cout << "Leaf kernel: " << leafKernel<Accumulator<T>>().name << std::endl;
+    std::cout << "Threshold: " << effectiveThreshold(options) << std::endl;
+    std::cout << "Schedule: " << scheduleName(options.schedule) << std::endl;
+    std::cout << "Threads: " << options.threads << ", warmups: " << config.warmups << ", trials: " << config.trials
+              << ", seed: " << config.seed << std::endl;
 
     // Use a fixed seed for repeatable random matrices
-    std::srand(std::time(0)); 
+    std::srand(config.seed);
 
-    std::vector<int> sizes = {64, 128, 256, 512};
+    std::vector<BenchmarkResult> results;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n" << std::setw(8) << "Size" << std::setw(10) << "Algo" << std::setw(12) << "Min (ms)"
+              << std::setw(13) << "Median (ms)" << std::setw(12) << "p95 (ms)" << std::setw(10) << "GFLOP/s"
+              << std::setw(8) << "Match" << std::endl;
+
+    for (int n : config.sizes) {
+        Matrix<T> A = generateRandomMatrix<T>(n, n, 100);
+        Matrix<T> B = generateRandomMatrix<T>(n, n, 100);
 
-    for (int n : sizes) {
-        std::cout << "\nMatrix size: " << n << " x " << n << std::endl;
+        // Verify results are the same before timing anything
+        bool resultsMatch = matricesEqual(strassenMultiply(A, B, options), standardMultiply(A, B));
 
-        Matrix A = generateRandomMatrix(n, n, 100);
-        Matrix B = generateRandomMatrix(n, n, 100);
+        TimingStats strassenStats = timeTrials([&] { strassenMultiply(A, B, options); }, config.warmups, config.trials);
+        TimingStats standardStats = timeTrials([&] { standardMultiply(A, B); }, config.warmups, config.trials);
 
-        // Test Strassen algorithm
-        std::clock_t startTime = std::clock();
-        Matrix strassenResult = strassenMultiply(A, B);
-        double strassenTime = (std::clock() - startTime) / (double) CLOCKS_PER_SEC * 1000.0;
+        results.push_back({"strassen", n, options.threads, strassenStats, gflopsFor(n, strassenStats.medianMs), resultsMatch});
+        results.push_back({"standard", n, 1, standardStats, gflopsFor(n, standardStats.medianMs), true});
 
-        // Test standard algorithm
-        startTime = std::clock();
-        Matrix standardResult = standardMultiply(A, B);
-        double standardTime = (std::clock() - startTime) / (double) CLOCKS_PER_SEC * 1000.0;
+        for (size_t i = results.size() - 2; i < results.size(); i++) {
+            const BenchmarkResult& r = results[i];
+            std::cout << std::setw(8) << n << std::setw(10) << r.algorithm << std::setw(12) << r.stats.minMs
+                      << std::setw(13) << r.stats.medianMs << std::setw(12) << r.stats.p95Ms
+                      << std::setw(10) << r.gflops << std::setw(8) << (r.matches ? "yes" : "NO") << std::endl;
+        }
+        std::cout << std::setw(8) << "" << " Speedup (median): "
+                  << standardStats.medianMs / std::max(strassenStats.medianMs, 1e-9) << "x" << std::endl;
+    }
 
-        // Verify results are the same
-        bool resultsMatch = matricesEqual(strassenResult, standardResult);
+    if (config.scaling) {
+        scalingReport<T>(options, config, results);
+    }
 
-        std::cout << std::fixed << std::setprecision(2);
-        std::cout << "Strassen time: " << strassenTime << " ms" << std::endl;
-        std::cout << "Standard time: " << standardTime << " ms" << std::endl;
-        
-        if (strassenTime > 0) {
-             std::cout << "Speedup: " << standardTime / strassenTime << "x" << std::endl;
-        } else {
-             std::cout << "Speedup: N/A (Time too short)" << std::endl;
+    if (!config.csvPath.empty()) {
+        writeBenchmarkCsv<T>(config.csvPath, results, options, config);
+    }
+    if (!config.jsonPath.empty()) {
+        writeBenchmarkJson<T>(config.jsonPath, results, options, config);
+    }
+}
+
+/**
+ * Batched small multiplies: time batchedMultiply on a batch of random n x n pairs
+ * against calling strassenMultiply once per pair, and check a sample of the results
+ */
+template <typename T>
+void handleBatched(const StrassenOptions& options) {
+    using Acc = Accumulator<T>;
+    int n;
+    size_t count;
+
+    std::cout << "Enter matrix size n (e.g. 4 to 32): ";
+    std::cin >> n;
+    std::cout << "Enter number of pairs in the batch: ";
+    std::cin >> count;
+    if (n <= 0 || count == 0) {
+        throw std::invalid_argument("Matrix size and batch count must be positive.");
+    }
+
+    size_t elements = static_cast<size_t>(n) * n;
+    std::vector<T> A(count * elements);
+    std::vector<T> B(count * elements);
+    std::vector<Acc> C(count * elements);
+    for (size_t i = 0; i < A.size(); i++) {
+        A[i] = static_cast<T>((std::rand() % 201) - 100);
+        B[i] = static_cast<T>((std::rand() % 201) - 100);
+    }
+
+    TimingStats batched = timeTrials([&] { batchedMultiply(A.data(), B.data(), C.data(), count, n, n, n, options); }, 1, 5);
+
+    // The per-pair path copies each pair into Matrix objects, as a caller without the batch API would
+    TimingStats perPair = timeTrials([&] {
+        for (size_t b = 0; b < count; b++) {
+            Matrix<T> a(n, n), bm(n, n);
+            std::copy(A.begin() + b * elements, A.begin() + (b + 1) * elements, a.data());
+            std::copy(B.begin() + b * elements, B.begin() + (b + 1) * elements, bm.data());
+            strassenMultiply(a, bm, options);
         }
-        
-        std::cout << "Results match: " << (resultsMatch ? "true" : "false") << std::endl;
+    }, 0, 1);
+
+    bool allMatch = true;
+    for (size_t b = 0; b < count; b += std::max<size_t>(1, count / 16)) {
+        Matrix<T> a(n, n), bm(n, n);
+        Matrix<Acc> got(n, n);
+        std::copy(A.begin() + b * elements, A.begin() + (b + 1) * elements, a.data());
+        std::copy(B.begin() + b * elements, B.begin() + (b + 1) * elements, bm.data());
+        std::copy(C.begin() + b * elements, C.begin() + (b + 1) * elements, got.data());
+        allMatch = allMatch && matricesEqual(got, standardMultiply(a, bm));
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n=== Batched " << count << " x (" << n << " x " << n << ") multiplies, "
+              << elementTypeName<T>() << " ===" << std::endl;
+    std::cout << "Batch kernel: " << batchKernelFor<T>(n, n, n).name << std::endl;
+    std::cout << "Batched (median of 5): " << batched.medianMs << " ms, "
+              << 2.0 * n * n * n * count / (batched.medianMs * 1e6) << " GFLOP/s" << std::endl;
+    std::cout << "Per-pair strassenMultiply: " << perPair.medianMs << " ms" << std::endl;
+    std::cout << "Speedup: " << perPair.medianMs / std::max(batched.medianMs, 1e-9) << "x" << std::endl;
+    std::cout << "Results match: " << (allMatch ? "true" : "false") << std::endl;
+}
+
+/**
+ * Element types the driver can run the engine with
+ */
+enum class ElementType { Int32, Int64, Float, Double, Modular };
+
+template <typename T>
+struct TypeTag {
+    using type = T;
+};
+
+/**
+ * Call fn(TypeTag<T>()) for the runtime-selected element type
+ */
+template <typename Fn>
+void withElementType(ElementType type, Fn&& fn) {
+    switch (type) {
+        case ElementType::Int32: fn(TypeTag<int32_t>()); break;
+        case ElementType::Int64: fn(TypeTag<int64_t>()); break;
+        case ElementType::Float: fn(TypeTag<float>()); break;
+        case ElementType::Double: fn(TypeTag<double>()); break;
+        case ElementType::Modular: fn(TypeTag<ModP>()); break;
     }
 }
 
+bool parseElementType(const std::string& name, ElementType& type) {
+    if (name == "int32") type = ElementType::Int32;
+    else if (name == "int64") type = ElementType::Int64;
+    else if (name == "float") type = ElementType::Float;
+    else if (name == "double") type = ElementType::Double;
+    else if (name == "mod") type = ElementType::Modular;
+    else return false;
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--threads N] [--parallel-depth D] [--threshold T] [--config FILE]"
+              << " [--type int32|int64|float|double|mod] [--schedule classic|winograd]" << std::endl;
+    std::cerr << "  --threads N         worker threads for Strassen (0 = all hardware threads, default 1)" << std::endl;
+    std::cerr << "  --parallel-depth D  recursion levels that run M1..M7 as parallel tasks (default 2)" << std::endl;
+    std::cerr << "  --threshold T       leaf crossover, overrides the tuned value" << std::endl;
+    std::cerr << "  --config FILE       tuning file to load and save (default " << DEFAULT_TUNING_FILE << ")" << std::endl;
+    std::cerr << "  --type NAME         element type (default int32, computed with int64 accumulators)" << std::endl;
+    std::cerr << "  --schedule NAME     sequential level order: classic (default) or winograd" << std::endl;
+    std::cerr << "Benchmark (menu option 3):" << std::endl;
+    std::cerr << "  --bench             run the benchmark directly instead of showing the menu" << std::endl;
+    std::cerr << "  --sizes LIST        comma-separated square sizes (default 64,128,256,512)" << std::endl;
+    std::cerr << "  --warmups N         untimed runs per case (default 1)" << std::endl;
+    std::cerr << "  --trials N          timed runs per case (default 5)" << std::endl;
+    std::cerr << "  --seed S            random seed for the benchmark matrices (default 12345)" << std::endl;
+    std::cerr << "  --csv FILE          export results as CSV" << std::endl;
+    std::cerr << "  --json FILE         export results as JSON" << std::endl;
+    std::cerr << "  --no-scaling        skip the thread scaling table" << std::endl;
+}
+
 /**
  * Main method to demonstrate Strassen Matrix Multiplication
  */
-int main() {
-    // Seed the random number generator once
-    std::srand(std::time(0)); 
-    
-    int choice;
+int main(int argc, char* argv[]) {
+    StrassenOptions options;
+    std::string configPath = DEFAULT_TUNING_FILE;
+    ElementType elementType = ElementType::Int32;
+    BenchmarkConfig bench;
+    bool benchOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+            if (options.threads <= 0) {
+                options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            }
+        } else if (arg == "--parallel-depth" && i + 1 < argc) {
+            options.parallelDepth = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            options.threshold = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--config" && i + 1 < argc) {
+            configPath = argv[++i];
+        } else if (arg == "--type" && i + 1 < argc && parseElementType(argv[i + 1], elementType)) {
+            i++;
+        } else if (arg == "--schedule" && i + 1 < argc && parseSchedule(argv[i + 1], options.schedule)) {
+            i++;
+        } else if (arg == "--bench") {
+            benchOnly = true;
+        } else if (arg == "--sizes" && i + 1 < argc && parseSizeList(argv[i + 1], bench.sizes)) {
+            i++;
+        } else if (arg == "--warmups" && i + 1 < argc) {
+            bench.warmups = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--trials" && i + 1 < argc) {
+            bench.trials = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            bench.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--csv" && i + 1 < argc) {
+            bench.csvPath = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            bench.jsonPath = argv[++i];
+        } else if (arg == "--no-scaling") {
+            bench.scaling = false;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
 
-    std::cout << "=== Strassen Matrix Multiplication Algorithm ===" << std::endl;
-    std::cout << "1. Manual input" << std::endl;
-    std::cout << "2. Random matrices" << std::endl;
-    std::cout << "3. Performance comparison" << std::endl;
-    std::cout << "Choose an option (1-3): ";
+    // Pick up the crossover tuned for this machine, if any
+    loadTuningConfig(configPath);
 
-    if (!(std::cin >> choice)) {
-        // Handle non-integer input
-        std::cerr << "Invalid input." << std::endl;
-        return 1;
+    // Seed the random number generator once
+    std::srand(std::time(0));
+
+    // --bench runs the performance comparison without the interactive menu
+    int choice = 3;
+
+    if (!benchOnly) {
+        std::cout << "=== Strassen Matrix Multiplication Algorithm ===" << std::endl;
+        std::cout << "1. Manual input" << std::endl;
+        std::cout << "2. Random matrices" << std::endl;
+        std::cout << "3. Performance comparison" << std::endl;
+        std::cout << "4. Autotune threshold" << std::endl;
+        std::cout << "5. Out-of-core multiply (tiled files)" << std::endl;
+        std::cout << "6. Batched small multiplies" << std::endl;
+        std::cout << "7. Multiply matrices from files" << std::endl;
+        std::cout << "Choose an option (1-7): ";
+
+        if (!(std::cin >> choice)) {
+            // Handle non-integer input
+            std::cerr << "Invalid input." << std::endl;
+            return 1;
+        }
     }
 
     try {
-        switch (choice) {
-            case 1:
-                handleManualInput();
-                break;
-            case 2:
-                handleRandomMatrices();
-                break;
-            case 3:
-                performanceComparison();
-                break;
-            default:
-                std::cout << "Invalid choice!" << std::endl;
-        }
+        withElementType(elementType, [&](auto tag) {
+            using T = typename decltype(tag)::type;
+            switch (choice) {
+                case 1:
+                    handleManualInput<T>(options);
+                    break;
+                case 2:
+                    handleRandomMatrices<T>(options);
+                    break;
+                case 3:
+                    performanceComparison<T>(options, bench);
+                    break;
+                case 4:
+                    handleAutotune<T>(options, configPath);
+                    break;
+                case 5:
+#if STRASSEN_HAS_MMAP
+                    handleOutOfCore<T>();
+#else
+                    std::cout << "Out-of-core multiply needs mmap, which this platform does not provide." << std::endl;
+#endif
+                    break;
+                case 6:
+                    handleBatched<T>(options);
+                    break;
+                case 7:
+                    handleFileMultiply<T>(options);
+                    break;
+                default:
+                    std::cout << "Invalid choice!" << std::endl;
+            }
+        });
     } catch (const std::invalid_argument& e) {
         std::cerr << "Error: " << e.what() << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "I/O Error: " << e.what() << std::endl;
     } catch (const std::bad_alloc& e) {
         // Catch memory allocation errors for very large matrices
-        std::cerr << "Memory Allocation Error: Matrix size likely too large." << std::endl;
+        std::cerr << "Memory Allocation Error: Matrix size likely too large; try option 5 (out-of-core)." << std::endl;
     }
-    
+
     return 0;
-}
\ No newline at end of file
+}
@@ -2,11 +2,11 @@
  * =====================================================================================
  *
  * Filename:  dijkstra_algorithm.cpp
- * 
+ *
  * Author:  Hagemaruwu
  *
- * Description:  An implementation of Dijkstra's Shortest Path Algorithm using an
- * adjacency list and a priority queue (min-heap) for efficiency.
+ * Description:  An implementation of Dijkstra's Shortest Path Algorithm using a
+ * compressed sparse row (CSR) graph and a priority queue (min-heap) for efficiency.
  *
  * =====================================================================================
  *
@@ -22,8 +22,83 @@
  * number of edges. The log V factor comes from the priority queue
  * operations (insertion and extraction).
  *
- * Space Complexity:  O(V + E) to store the graph in an adjacency list.
- * Additional space for the distance array O(V) and priority queue O(V).
+ * Space Complexity:  O(V + E) to store the graph in CSR form.
+ * Additional space for the distance/predecessor arrays O(V) and priority queue O(E).
+ *
+ * =====================================================================================
+ *
+ * GRAPH REPRESENTATION
+ * --------------------
+ * The graph is built once from an edge list into CSR form: one offsets array
+ * of size V + 1 and two parallel arrays of edge targets and weights. The
+ * out-edges of u are the index range [offsets[u], offsets[u + 1]), so a
+ * relaxation scan reads contiguous memory instead of following one heap
+ * allocation per vertex.
+ *
+ * Queries go through a DijkstraEngine bound to the graph. It owns the distance,
+ * predecessor and heap buffers and reuses them across queries, only resetting
+ * the entries the previous query touched, so running many single-source
+ * queries on the same graph does no per-call allocation.
+ *
+ * The engine is a template over its priority queue. Four are provided:
+ * - LazyBinaryHeap: the classic heap with duplicate entries (stale pops skipped).
+ * - IndexedDaryHeap<4>: one entry per vertex with true decrease-key.
+ * - RadixHeap: monotone integer heap with bucket redistribution.
+ * - DialBuckets: circular distance buckets, for small integer weights.
+ * `--queue` picks one for the example and `--bench-queues SIDE` compares all
+ * of them on a generated grid road graph.
+ *
+ * WEIGHT TYPES
+ * ------------
+ * BasicCsrGraph, the queues and DijkstraEngine are also templates over the
+ * weight type: uint32_t (the Weight used throughout this file), uint64_t or
+ * double. Integer path lengths saturate at infiniteWeight<W>() instead of
+ * wrapping, so an overlong path reads as unreachable rather than short. The
+ * default queue is the radix heap for integer weights and the 4-ary heap for
+ * double. `--bench-weights SIDE` times the same graph with each weight type.
+ *
+ * PARALLEL MODE
+ * -------------
+ * DeltaSteppingEngine runs the same query across a ThreadPool by grouping
+ * tentative distances into buckets of width delta and relaxing each bucket's
+ * light edges in parallel phases, then its heavy edges once the bucket is
+ * settled. Distances match the sequential engine exactly. `--threads N` runs
+ * the example this way and `--bench-delta SIDE` reports speedup per thread count.
+ *
+ * POINT-TO-POINT QUERIES
+ * ----------------------
+ * When only the distance from s to t matters the search can stop early:
+ * engine.run(s, t) halts once t is settled, BidirectionalDijkstra grows one
+ * search from each end until they meet, and AStarEngine steers the search
+ * with an admissible heuristic such as EuclideanHeuristic over vertex
+ * coordinates. Work then grows with the region around the route instead of
+ * the whole graph. `--bench-st SIDE` compares all of them on a road grid.
+ *
+ * For a static network a ContractionHierarchy is built once offline and
+ * saved as an index file of flat arrays; MappedContractionHierarchy maps that
+ * file read-only and ChQueryEngine answers queries straight from the mapping,
+ * settling a few hundred vertices per query. `--bench-ch SIDE` runs the
+ * whole pipeline.
+ *
+ * BATCHED QUERIES
+ * ---------------
+ * engine.run(sources) runs once from a virtual super-source joined to every
+ * source, which answers nearest-facility questions (nearestFacilities) in one
+ * pass. ManyToManyEngine fills a compact row-major DistanceMatrix by running
+ * one early-exit search per source across a ThreadPool, with one reusable
+ * engine per worker. `--bench-many SIDE COUNT` compares both with calling
+ * dijkstra() once per source.
+ *
+ * DYNAMIC UPDATES
+ * ---------------
+ * DynamicShortestPaths keeps one source's shortest-path tree current while
+ * arc weights change. update() takes a batch of new weights, invalidates only
+ * the subtrees below increased tree arcs and runs a Dijkstra pass seeded from
+ * their boundary and from decreased arcs, so the work follows the size of the
+ * change rather than the graph. `--bench-dynamic SIDE BATCHES` times repairs
+ * of growing batches against a full rerun.
+ *
+ * Build with: g++ -std=c++17 -O2 -pthread dijkstra_algorithm.cpp
  *
  * =====================================================================================
  *
@@ -48,7 +123,7 @@
  * currently known distance to `v`, update the distance of `v`.
  * (i.e., if dist[u] + weight(u,v) < dist[v]).
  * - If a distance is updated, the neighbor `v` is added to the priority queue
- * with its new, shorter distance.
+ * with its new, shorter distance, and `u` is recorded as its predecessor.
  *
  * 3.  Termination:
  * - The algorithm ends when the priority queue is empty, meaning all reachable
@@ -62,92 +137,2845 @@
 #include <vector>
 #include <queue>
 #include <limits>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+#include <type_traits>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <cstring>
+#include <memory>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DIJKSTRA_HAS_MMAP 1
+#endif
+
+// -------------------------------------------------------------------------------------
+// Weights
+// -------------------------------------------------------------------------------------
+//
+// The graph, queues and engine are templates over the weight type W, so a graph
+// whose path lengths fit in 32 bits does not pay for 64-bit distances. uint32_t,
+// uint64_t, signed integers and double all work. Integer path lengths saturate at
+// infiniteWeight<W>() instead of wrapping around, so a path too long to represent
+// reads as unreachable rather than as a bogus short distance.
+
+// Distance of an unreachable vertex: the largest value, or +infinity for floating point
+template <typename W>
+constexpr W infiniteWeight() {
+    static_assert(std::is_arithmetic<W>::value, "Edge weights must be an arithmetic type");
+    return std::numeric_limits<W>::has_infinity ? std::numeric_limits<W>::infinity() : std::numeric_limits<W>::max();
+}
+
+// Path length a + b for non-negative a and b, clamped to infiniteWeight<W>()
+template <typename W>
+inline W addWeights(W a, W b) {
+    if constexpr (std::is_integral<W>::value) {
+        return b > infiniteWeight<W>() - a ? infiniteWeight<W>() : static_cast<W>(a + b);
+    } else {
+        return a + b;
+    }
+}
+
+// Dijkstra needs non-negative weights; this also rejects NaN
+template <typename W>
+inline bool isValidWeight(W w) {
+    if constexpr (std::is_unsigned<W>::value) {
+        return true;
+    } else {
+        return w >= W(0);
+    }
+}
+
+// Default edge weight and path length type used by the rest of this file
+using Weight = uint32_t;
+
+// Distance of an unreachable vertex
+const Weight INF = infiniteWeight<Weight>();
+
+// Use a type alias for cleaner code, representing a pair of {distance, vertex}
+using iPair = std::pair<Weight, int>;
+
+// A weighted edge from -> to, as read from an edge list
+template <typename W>
+struct BasicEdge {
+    int from;
+    int to;
+    W weight;
+};
+
+using Edge = BasicEdge<Weight>;
+
+// Graph in compressed sparse row form, built once and then read-only
+template <typename W>
+class BasicCsrGraph {
+public:
+    using weight_type = W;
+
+    BasicCsrGraph() = default;
+
+    // Build from an edge list; undirected graphs store every edge in both directions.
+    // Throws std::invalid_argument on an out-of-range vertex or a negative weight.
+    static BasicCsrGraph fromEdges(int V, const std::vector<BasicEdge<W>>& edges, bool undirected) {
+        BasicCsrGraph graph;
+        graph.offsets_.assign(V + 1, 0);
+
+        // Count the out-degree of every vertex
+        for (const BasicEdge<W>& e : edges) {
+            if (e.from < 0 || e.from >= V || e.to < 0 || e.to >= V) {
+                throw std::invalid_argument("Edge endpoint out of range");
+            }
+            if (!isValidWeight(e.weight)) {
+                throw std::invalid_argument("Dijkstra requires non-negative edge weights");
+            }
+            graph.offsets_[e.from + 1]++;
+            if (undirected) {
+                graph.offsets_[e.to + 1]++;
+            }
+        }
+
+        // Prefix sums turn degrees into the start of each vertex's edge range
+        for (int u = 0; u < V; ++u) {
+            graph.offsets_[u + 1] += graph.offsets_[u];
+        }
+
+        // Scatter the edges into place
+        graph.targets_.resize(graph.offsets_[V]);
+        graph.weights_.resize(graph.offsets_[V]);
+        std::vector<int> next(graph.offsets_.begin(), graph.offsets_.end() - 1);
+        auto place = [&](int u, int v, W w) {
+            graph.targets_[next[u]] = v;
+            graph.weights_[next[u]] = w;
+            next[u]++;
+        };
+        for (const BasicEdge<W>& e : edges) {
+            place(e.from, e.to, e.weight);
+            if (undirected) {
+                place(e.to, e.from, e.weight);
+            }
+            graph.maxWeight_ = std::max(graph.maxWeight_, e.weight);
+        }
+        return graph;
+    }
+
+    // The same graph with every arc turned around, for searches towards a target
+    BasicCsrGraph reversed() const {
+        std::vector<BasicEdge<W>> edges;
+        edges.reserve(targets_.size());
+        for (int u = 0; u < numVertices(); ++u) {
+            for (int e = edgesBegin(u); e < edgesEnd(u); ++e) {
+                edges.push_back({targets_[e], u, weights_[e]});
+            }
+        }
+        return fromEdges(numVertices(), edges, false);
+    }
+
+    int numVertices() const { return offsets_.empty() ? 0 : static_cast<int>(offsets_.size()) - 1; }
+    int numEdges() const { return static_cast<int>(targets_.size()); }
+    W maxWeight() const { return maxWeight_; }
+
+    // Out-edges of u are the indices [edgesBegin(u), edgesEnd(u))
+    int edgesBegin(int u) const { return offsets_[u]; }
+    int edgesEnd(int u) const { return offsets_[u + 1]; }
+    int target(int e) const { return targets_[e]; }
+    W weight(int e) const { return weights_[e]; }
+
+private:
+    std::vector<int> offsets_;
+    std::vector<int> targets_;
+    std::vector<W> weights_;
+    W maxWeight_ = 0;
+};
+
+using CsrGraph = BasicCsrGraph<Weight>;
+
+// -------------------------------------------------------------------------------------
+// Priority queues
+// -------------------------------------------------------------------------------------
+//
+// Every queue is a template over the weight type, keys vertices by tentative
+// distance and offers the same interface, so DijkstraEngine can be instantiated
+// with any of them:
+//
+//   void reset(const BasicCsrGraph<W>& g)  size internal arrays for this graph (once)
+//   void clear()                           drop everything left over from a query
+//   void push(int v, W key)                insert v, or lower its key (never raises it)
+//   bool empty() const
+//   std::pair<W, int> pop()                remove and return a {key, vertex} with minimum key
+//
+// The lazy queues implement push by inserting a duplicate entry, so pop can return a
+// stale {key, v} whose key is above dist[v]; the engine skips those. The indexed heap
+// never holds more than one entry per vertex. RadixHeap and DialBuckets index by the
+// key's bits or value and only compile for integer weights.
+
+// std::push_heap / pop_heap binary heap with duplicate entries (the classic textbook version)
+template <typename W = Weight>
+class LazyBinaryHeap {
+public:
+    using Entry = std::pair<W, int>;
+
+    void reset(const BasicCsrGraph<W>&) {}
+    void clear() { heap_.clear(); }
+    void push(int v, W key) {
+        heap_.push_back({key, v});
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+    }
+    bool empty() const { return heap_.empty(); }
+    Entry pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+        Entry top = heap_.back();
+        heap_.pop_back();
+        return top;
+    }
+
+private:
+    std::vector<Entry> heap_;
+};
+
+// Indexed D-ary min-heap with true decrease-key. pos_[v] tracks where v sits, so a
+// relaxation moves the existing entry up instead of adding a new one, and the heap
+// never holds more than V entries. D = 4 keeps the tree shallow while the children
+// of a node still share a cache line.
+template <int D, typename W = Weight>
+class IndexedDaryHeap {
+public:
+    using Entry = std::pair<W, int>;
+
+    void reset(const BasicCsrGraph<W>& graph) { resize(graph.numVertices()); }
+    void resize(int vertices) { pos_.assign(vertices, -1); }
+
+    void clear() {
+        for (const Entry& entry : heap_) {
+            pos_[entry.second] = -1;
+        }
+        heap_.clear();
+    }
+
+    void push(int v, W key) {
+        int i = pos_[v];
+        if (i < 0) {
+            i = static_cast<int>(heap_.size());
+            heap_.push_back({key, v});
+        } else {
+            heap_[i].first = key;
+        }
+        siftUp(i);
+    }
+
+    bool empty() const { return heap_.empty(); }
+
+    // Minimum entry without removing it; the heap must not be empty
+    const Entry& top() const { return heap_[0]; }
+
+    Entry pop() {
+        Entry top = heap_[0];
+        pos_[top.second] = -1;
+        Entry last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) {
+            heap_[0] = last;
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    void siftUp(int i) {
+        Entry entry = heap_[i];
+        while (i > 0) {
+            int parent = (i - 1) / D;
+            if (heap_[parent].first <= entry.first) {
+                break;
+            }
+            place(i, heap_[parent]);
+            i = parent;
+        }
+        place(i, entry);
+    }
+
+    void siftDown(int i) {
+        Entry entry = heap_[i];
+        int n = static_cast<int>(heap_.size());
+        while (true) {
+            int first = i * D + 1;
+            if (first >= n) {
+                break;
+            }
+            // Smallest of up to D children
+            int best = first;
+            int last = std::min(first + D, n);
+            for (int c = first + 1; c < last; ++c) {
+                if (heap_[c].first < heap_[best].first) {
+                    best = c;
+                }
+            }
+            if (heap_[best].first >= entry.first) {
+                break;
+            }
+            place(i, heap_[best]);
+            i = best;
+        }
+        place(i, entry);
+    }
+
+    void place(int i, const Entry& entry) {
+        heap_[i] = entry;
+        pos_[entry.second] = i;
+    }
+
+    std::vector<Entry> heap_;  // {key, vertex}
+    std::vector<int> pos_;     // index of v in heap_, or -1
+};
+
+// The 4-ary heap as a single-parameter template, for DijkstraEngine's Queue argument
+template <typename W>
+using QuaternaryHeap = IndexedDaryHeap<4, W>;
+
+// Monotone radix heap for integer keys (Ahuja, Mehlhorn, Orlin, Tarjan).
+// Bucket i holds keys whose highest bit differing from the last popped key is bit
+// i - 1, so each entry moves to a lower bucket at most once per key bit over its
+// life and push/pop cost amortized O(log C) with only cheap bit operations. Only
+// valid for Dijkstra-style use, where pushed keys are never below the last popped key.
+template <typename W = Weight>
+class RadixHeap {
+    static_assert(std::is_integral<W>::value, "RadixHeap needs integer weights");
+    using Bits = typename std::make_unsigned<W>::type;
+    static const int KEY_BITS = std::numeric_limits<Bits>::digits;
+
+public:
+    using Entry = std::pair<W, int>;
+
+    void reset(const BasicCsrGraph<W>&) {}
+
+    void clear() {
+        for (std::vector<Entry>& bucket : buckets_) {
+            bucket.clear();
+        }
+        size_ = 0;
+        last_ = 0;
+    }
+
+    void push(int v, W key) {
+        buckets_[bucketFor(key)].push_back({key, v});
+        size_++;
+    }
+
+    bool empty() const { return size_ == 0; }
+
+    Entry pop() {
+        if (buckets_[0].empty()) {
+            // Find the first non-empty bucket; its minimum becomes the new reference
+            // key, and redistributing the rest sends every entry to a lower bucket.
+            int i = 1;
+            while (buckets_[i].empty()) {
+                ++i;
+            }
+            std::vector<Entry>& bucket = buckets_[i];
+            last_ = std::min_element(bucket.begin(), bucket.end())->first;
+            for (const Entry& entry : bucket) {
+                buckets_[bucketFor(entry.first)].push_back(entry);
+            }
+            bucket.clear();
+        }
+        Entry top = buckets_[0].back();
+        buckets_[0].pop_back();
+        size_--;
+        return top;
+    }
+
+private:
+    int bucketFor(W key) const {
+        Bits diff = static_cast<Bits>(key) ^ static_cast<Bits>(last_);
+        if (diff == 0) {
+            return 0;
+        }
+        if constexpr (KEY_BITS <= 32) {
+            return 32 - __builtin_clz(static_cast<uint32_t>(diff));
+        } else {
+            return 64 - __builtin_clzll(static_cast<unsigned long long>(diff));
+        }
+    }
+
+    std::vector<Entry> buckets_[KEY_BITS + 1];
+    size_t size_ = 0;
+    W last_ = 0;
+};
+
+// Dial's algorithm: a circular array of maxWeight + 1 buckets indexed by distance.
+// Every live key lies in [current, current + maxWeight], so push and pop are O(1)
+// plus the scan over empty buckets. Best when edge weights are small integers.
+template <typename W = Weight>
+class DialBuckets {
+    static_assert(std::is_integral<W>::value, "DialBuckets needs integer weights");
+
+public:
+    using Entry = std::pair<W, int>;
+
+    // Throws std::invalid_argument if the largest weight needs too many buckets
+    void reset(const BasicCsrGraph<W>& graph) {
+        if (static_cast<uint64_t>(graph.maxWeight()) >= MAX_BUCKETS) {
+            throw std::invalid_argument("Dial buckets need small integer weights");
+        }
+        buckets_.assign(static_cast<size_t>(graph.maxWeight()) + 1, {});
+    }
+
+    void clear() {
+        for (std::vector<int>& bucket : buckets_) {
+            bucket.clear();
+        }
+        size_ = 0;
+        current_ = 0;
+    }
+
+    void push(int v, W key) {
+        buckets_[static_cast<size_t>(key) % buckets_.size()].push_back(v);
+        size_++;
+    }
+
+    bool empty() const { return size_ == 0; }
+
+    Entry pop() {
+        while (buckets_[static_cast<size_t>(current_) % buckets_.size()].empty()) {
+            current_++;
+        }
+        std::vector<int>& bucket = buckets_[static_cast<size_t>(current_) % buckets_.size()];
+        int v = bucket.back();
+        bucket.pop_back();
+        size_--;
+        return {current_, v};
+    }
+
+private:
+    static const uint64_t MAX_BUCKETS = uint64_t(1) << 24;
+
+    std::vector<std::vector<int>> buckets_;
+    size_t size_ = 0;
+    W current_ = 0;  // distance of the bucket being drained
+};
+
+// Default queue per weight type: the radix heap for integers, where it was the
+// fastest in --bench-queues, and the 4-ary heap for floating point
+template <typename W>
+using DefaultQueue = typename std::conditional<std::is_integral<W>::value, RadixHeap<W>, QuaternaryHeap<W>>::type;
+
+// Result of a single-source query.
+// dist[v] is infiniteWeight<W>() for unreachable vertices; pred[v] is the vertex
+// before v on a shortest path, or -1 for the source and unreachable vertices.
+template <typename W>
+struct BasicShortestPaths {
+    std::vector<W> dist;
+    std::vector<int> pred;
+};
+
+using ShortestPaths = BasicShortestPaths<Weight>;
+
+// Reusable single-source Dijkstra bound to one graph, parameterized on its
+// weight type and priority queue
+template <typename W = Weight, template <typename> class Queue = DefaultQueue>
+class DijkstraEngine {
+public:
+    using Graph = BasicCsrGraph<W>;
+    using Paths = BasicShortestPaths<W>;
+
+    explicit DijkstraEngine(const Graph& graph) : graph_(graph) {
+        result_.dist.assign(graph.numVertices(), infiniteWeight<W>());
+        result_.pred.assign(graph.numVertices(), -1);
+        queue_.reset(graph);
+    }
+
+    // Run from src. The returned reference stays valid until the next call.
+    // With a target the search stops once target is settled: its distance and
+    // path are final, other entries may be partial.
+    const Paths& run(int src, int target = -1) {
+        if (target >= graph_.numVertices()) {
+            throw std::invalid_argument("Target vertex out of range");
+        }
+        return search(&src, &src + 1, [target](int u) { return u == target; });
+    }
+
+    // Multi-source run from a virtual super-source joined to every source by a
+    // zero-weight edge: dist[v] is the distance to the nearest source, and the
+    // predecessor chain of v ends at that source
+    const Paths& run(const std::vector<int>& sources) {
+        return search(sources.data(), sources.data() + sources.size(), [](int) { return false; });
+    }
+
+    // Run that ends as soon as stop(u) returns true for a settled vertex u;
+    // everything settled up to then is final
+    template <typename Stop>
+    const Paths& runUntil(int src, Stop&& stop) {
+        return search(&src, &src + 1, stop);
+    }
+
+    template <typename Stop>
+    const Paths& runUntil(const std::vector<int>& sources, Stop&& stop) {
+        return search(sources.data(), sources.data() + sources.size(), stop);
+    }
+
+    // Vertices settled (expanded) by the last query
+    int settledCount() const { return settled_; }
 
-// Use a type alias for cleaner code, representing a pair of {weight, vertex}
-using iPair = std::pair<int, int>;
+private:
+    template <typename Stop>
+    const Paths& search(const int* first, const int* last, Stop&& stop) {
+        for (const int* s = first; s != last; ++s) {
+            if (*s < 0 || *s >= graph_.numVertices()) {
+                throw std::invalid_argument("Source vertex out of range");
+            }
+        }
+        reset();
 
-// Function to perform Dijkstra's algorithm
-void dijkstra(int V, std::vector<iPair> adj[], int src) {
-    // A priority queue to store vertices that are being preprocessed.
-    // We use std::greater to make it a min-heap.
-    // The pair stores {distance, vertex}. We store distance first to sort by it.
-    std::priority_queue<iPair, std::vector<iPair>, std::greater<iPair>> pq;
+        std::vector<W>& dist = result_.dist;
 
-    // Create a vector for distances and initialize all distances as infinite.
-    std::vector<int> dist(V, std::numeric_limits<int>::max());
+        // Insert the sources in the priority queue and initialize their distance as 0.
+        for (const int* s = first; s != last; ++s) {
+            if (dist[*s] != W(0)) {
+                setDistance(*s, 0, -1);
+                queue_.push(*s, 0);
+            }
+        }
 
-    // Insert source itself in priority queue and initialize its distance as 0.
-    pq.push({0, src});
-    dist[src] = 0;
+        // The main loop continues until the priority queue is empty.
+        while (!queue_.empty()) {
+            // Extract the vertex with the minimum distance value.
+            std::pair<W, int> top = queue_.pop();
+            int u = top.second;
 
-    // The main loop continues until the priority queue is empty.
-    while (!pq.empty()) {
-        // Extract the vertex with the minimum distance value.
-        int u = pq.top().second;
-        pq.pop();
+            // Lazy queues leave stale duplicates behind; u was already settled with a smaller key
+            if (top.first > dist[u]) {
+                continue;
+            }
+            settled_++;
+            if (stop(u)) {
+                break;
+            }
 
-        // Iterate through all adjacent vertices of the extracted vertex 'u'.
-        for (auto& edge : adj[u]) {
-            int v = edge.first;
-            int weight = edge.second;
+            // Iterate through all adjacent vertices of the extracted vertex 'u'.
+            for (int e = graph_.edgesBegin(u); e < graph_.edgesEnd(u); ++e) {
+                int v = graph_.target(e);
 
-            // Relaxation step: If there is a shorter path to v through u.
-            if (dist[u] != std::numeric_limits<int>::max() && dist[u] + weight < dist[v]) {
-                // Update the distance of v.
-                dist[v] = dist[u] + weight;
-                // Push the updated vertex to the priority queue.
-                pq.push({dist[v], v});
+                // Relaxation step: If there is a shorter path to v through u.
+                // A saturated sum equals infinity and never relaxes anything.
+                W candidate = addWeights(dist[u], graph_.weight(e));
+                if (candidate < dist[v]) {
+                    setDistance(v, candidate, u);
+                    queue_.push(v, candidate);
+                }
             }
         }
+
+        return result_;
+    }
+
+    void setDistance(int v, W d, int parent) {
+        if (result_.dist[v] == infiniteWeight<W>()) {
+            touched_.push_back(v);
+        }
+        result_.dist[v] = d;
+        result_.pred[v] = parent;
+    }
+
+    // Restore only the entries the previous query wrote
+    void reset() {
+        for (int v : touched_) {
+            result_.dist[v] = infiniteWeight<W>();
+            result_.pred[v] = -1;
+        }
+        touched_.clear();
+        queue_.clear();
+        settled_ = 0;
+    }
+
+    const Graph& graph_;
+    Paths result_;
+    std::vector<int> touched_;  // vertices given a finite distance by the current query
+    Queue<W> queue_;            // capacity kept between queries
+    int settled_ = 0;
+};
+
+// Priority queues selectable at run time
+enum class QueueKind { Lazy, Dary, Radix, Dial };
+
+const char* queueName(QueueKind kind) {
+    switch (kind) {
+        case QueueKind::Lazy: return "lazy binary heap";
+        case QueueKind::Dary: return "indexed 4-ary heap";
+        case QueueKind::Radix: return "radix heap";
+        case QueueKind::Dial: return "Dial buckets";
+    }
+    return "?";
+}
+
+bool parseQueueKind(const std::string& name, QueueKind& kind) {
+    if (name == "lazy") kind = QueueKind::Lazy;
+    else if (name == "dary") kind = QueueKind::Dary;
+    else if (name == "radix") kind = QueueKind::Radix;
+    else if (name == "dial") kind = QueueKind::Dial;
+    else return false;
+    return true;
+}
+
+// Call fn(engine) with an engine over graph that uses the selected queue.
+// Throws std::invalid_argument for an integer-only queue on floating-point weights.
+template <typename W, typename Fn>
+void withEngine(const BasicCsrGraph<W>& graph, QueueKind kind, Fn&& fn) {
+    switch (kind) {
+        case QueueKind::Lazy: { DijkstraEngine<W, LazyBinaryHeap> engine(graph); fn(engine); return; }
+        case QueueKind::Dary: { DijkstraEngine<W, QuaternaryHeap> engine(graph); fn(engine); return; }
+        default: break;
+    }
+    if constexpr (std::is_integral<W>::value) {
+        if (kind == QueueKind::Radix) {
+            DijkstraEngine<W, RadixHeap> engine(graph);
+            fn(engine);
+        } else {
+            DijkstraEngine<W, DialBuckets> engine(graph);
+            fn(engine);
+        }
+    } else {
+        throw std::invalid_argument(std::string(queueName(kind)) + " needs integer weights");
+    }
+}
+
+// One-off convenience wrapper; prefer a DijkstraEngine for repeated queries
+template <typename W>
+BasicShortestPaths<W> dijkstra(const BasicCsrGraph<W>& graph, int src) {
+    DijkstraEngine<W> engine(graph);
+    return engine.run(src);
+}
+
+// Walk the predecessor array back from target; empty if target is unreachable
+template <typename W>
+std::vector<int> extractPath(const BasicShortestPaths<W>& paths, int target) {
+    std::vector<int> path;
+    if (paths.dist[target] == infiniteWeight<W>()) {
+        return path;
     }
+    for (int v = target; v != -1; v = paths.pred[v]) {
+        path.push_back(v);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
 
-    // Print the calculated shortest distances
+// Print the calculated shortest distances
+template <typename W>
+void printDistances(const BasicShortestPaths<W>& paths, int src) {
     std::cout << "Vertex\t Distance from Source " << src << "\n";
     std::cout << "------\t ----------------------\n";
-    for (int i = 0; i < V; ++i) {
-        if (dist[i] == std::numeric_limits<int>::max()) {
+    for (size_t i = 0; i < paths.dist.size(); ++i) {
+        if (paths.dist[i] == infiniteWeight<W>()) {
             std::cout << i << "\t\t" << "INF" << "\n";
         } else {
-            std::cout << i << "\t\t" << dist[i] << "\n";
+            std::cout << i << "\t\t" << paths.dist[i] << "\n";
         }
     }
 }
 
-// Main function to create a graph and run Dijkstra's algorithm
-int main() {
-    // Number of vertices in the graph
-    int V = 9;
+// -------------------------------------------------------------------------------------
+// Point-to-point queries
+// -------------------------------------------------------------------------------------
 
-    // Adjacency list representation of the graph
-    std::vector<iPair> adj[V];
+// Answer to an s-t query. distance is INF and path empty when t is unreachable.
+struct PointToPoint {
+    Weight distance = INF;
+    std::vector<int> path;  // s, ..., t
+    int settled = 0;        // vertices expanded, i.e. the size of the search space
+};
 
-    // Function to add an edge to the graph
-    auto addEdge = [&](int u, int v, int w) {
-        adj[u].push_back({v, w});
-        adj[v].push_back({u, w}); // For an undirected graph
+// Early-exit s-t query on a plain engine: the search stops as soon as t is settled
+template <template <typename> class Queue>
+PointToPoint shortestPath(DijkstraEngine<Weight, Queue>& engine, int s, int t) {
+    PointToPoint answer;
+    const ShortestPaths& paths = engine.run(s, t);
+    answer.distance = paths.dist[t];
+    answer.path = extractPath(paths, t);
+    answer.settled = engine.settledCount();
+    return answer;
+}
+
+// Bidirectional Dijkstra: one search forward from s over the graph and one
+// backward from t over its reverse, expanding whichever side has the smaller
+// frontier key. Every edge relaxed into a vertex the other side has reached
+// offers a candidate s-t path; once the two frontier keys sum to at least the
+// best candidate, no unexplored path can be shorter. On road-like graphs each
+// side only explores a ball of half the radius.
+class BidirectionalDijkstra {
+public:
+    // reverse must be graph.reversed(); for undirected graphs pass graph itself
+    BidirectionalDijkstra(const CsrGraph& graph, const CsrGraph& reverse) : forward_(graph), backward_(reverse) {
+        if (graph.numVertices() != reverse.numVertices()) {
+            throw std::invalid_argument("Reverse graph has a different vertex count");
+        }
+    }
+
+    PointToPoint query(int s, int t) {
+        forward_.start(s);
+        backward_.start(t);
+        Weight best = INF;
+        int meet = -1;
+        if (s == t) {
+            best = 0;
+            meet = s;
+        }
+
+        while (!forward_.queue.empty() && !backward_.queue.empty()) {
+            Weight forwardKey = forward_.queue.top().first;
+            Weight backwardKey = backward_.queue.top().first;
+            if (best != INF && addWeights(forwardKey, backwardKey) >= best) {
+                break;
+            }
+            if (forwardKey <= backwardKey) {
+                forward_.step(backward_, best, meet);
+            } else {
+                backward_.step(forward_, best, meet);
+            }
+        }
+
+        PointToPoint answer;
+        answer.settled = forward_.settled + backward_.settled;
+        if (meet < 0) {
+            return answer;
+        }
+        answer.distance = best;
+        for (int v = meet; v != -1; v = forward_.pred[v]) {
+            answer.path.push_back(v);
+        }
+        std::reverse(answer.path.begin(), answer.path.end());
+        for (int v = backward_.pred[meet]; v != -1; v = backward_.pred[v]) {
+            answer.path.push_back(v);
+        }
+        return answer;
+    }
+
+private:
+    // One direction of the search; buffers are reused and reset via `touched`
+    struct Side {
+        explicit Side(const CsrGraph& g) : graph(g), dist(g.numVertices(), INF), pred(g.numVertices(), -1) {
+            queue.reset(g);
+        }
+
+        void start(int src) {
+            if (src < 0 || src >= graph.numVertices()) {
+                throw std::invalid_argument("Query vertex out of range");
+            }
+            for (int v : touched) {
+                dist[v] = INF;
+                pred[v] = -1;
+            }
+            touched.clear();
+            queue.clear();
+            settled = 0;
+            dist[src] = 0;
+            touched.push_back(src);
+            queue.push(src, 0);
+        }
+
+        // Settle the closest frontier vertex and update the best meeting point
+        void step(const Side& other, Weight& best, int& meet) {
+            int u = queue.pop().second;
+            settled++;
+            for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e) {
+                int v = graph.target(e);
+                Weight d = addWeights(dist[u], graph.weight(e));
+                if (d < dist[v]) {
+                    if (dist[v] == INF) {
+                        touched.push_back(v);
+                    }
+                    dist[v] = d;
+                    pred[v] = u;
+                    queue.push(v, d);
+                }
+                if (addWeights(d, other.dist[v]) < best) {
+                    best = addWeights(d, other.dist[v]);
+                    meet = v;
+                }
+            }
+        }
+
+        const CsrGraph& graph;
+        std::vector<Weight> dist;
+        std::vector<int> pred;  // towards this side's source
+        std::vector<int> touched;
+        IndexedDaryHeap<4> queue;
+        int settled = 0;
     };
 
-    // Creating the graph from the example
-    addEdge(0, 1, 4);
-    addEdge(0, 7, 8);
-    addEdge(1, 2, 8);
-    addEdge(1, 7, 11);
-    addEdge(2, 3, 7);
-    addEdge(2, 8, 2);
-    addEdge(2, 5, 4);
-    addEdge(3, 4, 9);
-    addEdge(3, 5, 14);
-    addEdge(4, 5, 10);
-    addEdge(5, 6, 2);
-    addEdge(6, 7, 1);
-    addEdge(6, 8, 6);
-    addEdge(7, 8, 7);
+    Side forward_;
+    Side backward_;
+};
 
-    // Set the source vertex
-    int source = 0;
+// Trivial heuristic; A* with it is plain early-exit Dijkstra
+struct ZeroHeuristic {
+    Weight operator()(int, int) const { return 0; }
+};
 
-    // Run Dijkstra's algorithm
-    dijkstra(V, adj, source);
+struct Point {
+    double x;
+    double y;
+};
 
-    return 0;
-}
\ No newline at end of file
+// Straight-line lower bound for graphs with vertex coordinates. The scale is
+// the smallest weight per unit of length over all edges, so scale * |v - t|
+// never exceeds the true remaining distance; rounding down keeps it integral
+// without breaking that bound or consistency.
+class EuclideanHeuristic {
+public:
+    static EuclideanHeuristic fromGraph(const CsrGraph& graph, std::vector<Point> coords) {
+        if (static_cast<int>(coords.size()) != graph.numVertices()) {
+            throw std::invalid_argument("Need one coordinate per vertex");
+        }
+        double scale = std::numeric_limits<double>::infinity();
+        for (int u = 0; u < graph.numVertices(); ++u) {
+            for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e) {
+                double length = distanceBetween(coords[u], coords[graph.target(e)]);
+                if (length > 0) {
+                    scale = std::min(scale, graph.weight(e) / length);
+                }
+            }
+        }
+        if (scale == std::numeric_limits<double>::infinity()) {
+            scale = 0;
+        }
+        return EuclideanHeuristic(std::move(coords), scale);
+    }
+
+    Weight operator()(int v, int t) const {
+        return static_cast<Weight>(scale_ * distanceBetween(coords_[v], coords_[t]));
+    }
+
+    double scale() const { return scale_; }
+
+private:
+    EuclideanHeuristic(std::vector<Point> coords, double scale) : coords_(std::move(coords)), scale_(scale) {}
+
+    static double distanceBetween(const Point& a, const Point& b) { return std::hypot(a.x - b.x, a.y - b.y); }
+
+    std::vector<Point> coords_;
+    double scale_;
+};
+
+// A* search: Dijkstra ordered by dist[v] + h(v, t), so the search is pulled
+// towards t. Heuristic is any callable h(v, t) that never overestimates the
+// remaining distance (admissible). Vertices are re-opened when a shorter path
+// turns up, so the answer stays exact even if h is admissible but not
+// consistent; with a consistent h each vertex is expanded at most once.
+template <typename Heuristic = ZeroHeuristic>
+class AStarEngine {
+public:
+    explicit AStarEngine(const CsrGraph& graph, Heuristic heuristic = Heuristic())
+        : graph_(graph), heuristic_(std::move(heuristic)), dist_(graph.numVertices(), INF),
+          pred_(graph.numVertices(), -1) {
+        queue_.reset(graph);
+    }
+
+    PointToPoint query(int s, int t) {
+        if (s < 0 || s >= graph_.numVertices() || t < 0 || t >= graph_.numVertices()) {
+            throw std::invalid_argument("Query vertex out of range");
+        }
+        reset();
+
+        PointToPoint answer;
+        setDistance(s, 0, -1);
+        queue_.push(s, heuristic_(s, t));
+        while (!queue_.empty()) {
+            iPair top = queue_.pop();
+            int u = top.second;
+            answer.settled++;
+            if (u == t) {
+                answer.distance = dist_[t];
+                for (int v = t; v != -1; v = pred_[v]) {
+                    answer.path.push_back(v);
+                }
+                std::reverse(answer.path.begin(), answer.path.end());
+                break;
+            }
+            for (int e = graph_.edgesBegin(u); e < graph_.edgesEnd(u); ++e) {
+                int v = graph_.target(e);
+                Weight d = addWeights(dist_[u], graph_.weight(e));
+                if (d < dist_[v]) {
+                    setDistance(v, d, u);
+                    queue_.push(v, addWeights(d, heuristic_(v, t)));
+                }
+            }
+        }
+        return answer;
+    }
+
+private:
+    void setDistance(int v, Weight d, int parent) {
+        if (dist_[v] == INF) {
+            touched_.push_back(v);
+        }
+        dist_[v] = d;
+        pred_[v] = parent;
+    }
+
+    void reset() {
+        for (int v : touched_) {
+            dist_[v] = INF;
+            pred_[v] = -1;
+        }
+        touched_.clear();
+        queue_.clear();
+    }
+
+    const CsrGraph& graph_;
+    Heuristic heuristic_;
+    std::vector<Weight> dist_;
+    std::vector<int> pred_;
+    std::vector<int> touched_;
+    IndexedDaryHeap<4> queue_;  // keyed by dist + heuristic; decrease-key re-opens vertices
+};
+
+// -------------------------------------------------------------------------------------
+// Contraction hierarchies
+// -------------------------------------------------------------------------------------
+//
+// Preprocessing contracts vertices one at a time in order of importance. Removing
+// v adds a shortcut u -> w for every pair of remaining neighbours whose shortest
+// path ran through v, so distances among the remaining vertices are preserved.
+// The vertex order is its rank. Afterwards every shortest path can be found as
+// an upward path from s meeting a downward path into t, so a query is a
+// bidirectional Dijkstra that only follows arcs towards higher ranks and
+// settles a few hundred vertices even on continental graphs.
+//
+// Each vertex keeps two upward arc lists: forward arcs v -> w and backward arcs
+// u -> v (stored at v, pointing at u), both to higher-ranked vertices. A
+// shortcut records the vertex it bypassed so paths can be unpacked.
+
+// Upward arc of the hierarchy; middle is the bypassed vertex, or -1 for an original edge
+struct ChArc {
+    int target;
+    Weight weight;
+    int middle;
+};
+
+// Read-only view of a hierarchy's arrays, either owned or memory-mapped
+struct ChView {
+    int numVertices = 0;
+    const int* forwardOffsets = nullptr;   // numVertices + 1 entries into forwardArcs
+    const ChArc* forwardArcs = nullptr;
+    const int* backwardOffsets = nullptr;  // numVertices + 1 entries into backwardArcs
+    const ChArc* backwardArcs = nullptr;
+};
+
+// Index file layout: this header, then forward offsets, backward offsets,
+// forward arcs and backward arcs, each a plain array in host byte order
+struct ChFileHeader {
+    char magic[8];       // "DIJKCH01"
+    uint32_t weightBytes;
+    uint32_t arcBytes;
+    uint64_t vertices;
+    uint64_t forwardArcs;
+    uint64_t backwardArcs;
+    uint64_t reserved[3];
+};
+
+const char CH_MAGIC[8] = {'D', 'I', 'J', 'K', 'C', 'H', '0', '1'};
+
+// Vertex contraction with bounded witness searches. Lives only for the
+// duration of ContractionHierarchy::build.
+class ChContractor {
+public:
+    explicit ChContractor(const CsrGraph& graph)
+        : out_(graph.numVertices()), in_(graph.numVertices()), contracted_(graph.numVertices(), false),
+          contractedNeighbours_(graph.numVertices(), 0), witnessDist_(graph.numVertices(), INF),
+          isTarget_(graph.numVertices(), false) {
+        for (int u = 0; u < graph.numVertices(); ++u) {
+            for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e) {
+                if (graph.target(e) != u) {
+                    addArc(u, graph.target(e), graph.weight(e), -1);
+                }
+            }
+        }
+        witnessQueue_.reset(graph);
+    }
+
+    // Contract every vertex; upward arcs are appended to the per-vertex lists
+    void run(std::vector<std::vector<ChArc>>& forward, std::vector<std::vector<ChArc>>& backward) {
+        int V = static_cast<int>(out_.size());
+        // Lazy priority queue of {priority, v}: a popped vertex is re-evaluated
+        // and only contracted if it is still no worse than the next candidate
+        using Candidate = std::pair<int, int>;
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> order;
+        for (int v = 0; v < V; ++v) {
+            order.push({priority(v), v});
+        }
+        while (!order.empty()) {
+            int v = order.top().second;
+            order.pop();
+            if (contracted_[v]) {
+                continue;
+            }
+            int current = priority(v);
+            if (!order.empty() && current > order.top().first) {
+                order.push({current, v});
+                continue;
+            }
+
+            // Freeze v's remaining arcs as its upward arcs, then bypass it
+            forward[v] = out_[v];
+            backward[v] = in_[v];
+            contract(v, false);
+            contracted_[v] = true;
+            for (const ChArc& arc : out_[v]) {
+                removeArc(in_[arc.target], v);
+                contractedNeighbours_[arc.target]++;
+            }
+            for (const ChArc& arc : in_[v]) {
+                removeArc(out_[arc.target], v);
+                contractedNeighbours_[arc.target]++;
+            }
+            out_[v].clear();
+            in_[v].clear();
+            out_[v].shrink_to_fit();
+            in_[v].shrink_to_fit();
+        }
+    }
+
+    long long shortcutsAdded() const { return shortcutsAdded_; }
+
+private:
+    // Edge difference plus contracted neighbours: prefer vertices whose removal
+    // adds few shortcuts, and spread contraction evenly over the graph
+    int priority(int v) {
+        int added = contract(v, true);
+        int removed = static_cast<int>(in_[v].size() + out_[v].size());
+        return 2 * (added - removed) + contractedNeighbours_[v];
+    }
+
+    // Count (simulate) or insert the shortcuts needed to remove v
+    int contract(int v, bool simulate) {
+        int needed = 0;
+        Weight maxOut = 0;
+        for (const ChArc& arc : out_[v]) {
+            maxOut = std::max(maxOut, arc.weight);
+            isTarget_[arc.target] = true;
+        }
+        for (const ChArc& in : in_[v]) {
+            int u = in.target;
+            witnessSearch(u, v, addWeights(in.weight, maxOut), simulate ? SIMULATE_SETTLE_LIMIT : CONTRACT_SETTLE_LIMIT);
+            for (const ChArc& out : out_[v]) {
+                int w = out.target;
+                if (w == u) {
+                    continue;
+                }
+                Weight via = addWeights(in.weight, out.weight);
+                if (witnessDist_[w] <= via) {
+                    continue;
+                }
+                needed++;
+                if (!simulate) {
+                    addArc(u, w, via, v);
+                    shortcutsAdded_++;
+                }
+            }
+        }
+        for (const ChArc& arc : out_[v]) {
+            isTarget_[arc.target] = false;
+        }
+        return needed;
+    }
+
+    // Dijkstra from u that avoids v, bounded by distance and settled count, and
+    // finished once every out-neighbour of v is settled; a missed witness only
+    // costs a redundant shortcut, never a wrong answer
+    void witnessSearch(int u, int v, Weight limit, int settleLimit) {
+        int targetsLeft = static_cast<int>(out_[v].size());
+        for (int x : witnessTouched_) {
+            witnessDist_[x] = INF;
+        }
+        witnessTouched_.clear();
+        witnessQueue_.clear();
+        witnessDist_[u] = 0;
+        witnessTouched_.push_back(u);
+        witnessQueue_.push(u, 0);
+        for (int settled = 0; !witnessQueue_.empty() && settled < settleLimit; ++settled) {
+            iPair top = witnessQueue_.pop();
+            if (top.first > limit || (isTarget_[top.second] && --targetsLeft == 0)) {
+                break;
+            }
+            for (const ChArc& arc : out_[top.second]) {
+                if (arc.target == v) {
+                    continue;
+                }
+                Weight d = addWeights(top.first, arc.weight);
+                if (d < witnessDist_[arc.target]) {
+                    if (witnessDist_[arc.target] == INF) {
+                        witnessTouched_.push_back(arc.target);
+                    }
+                    witnessDist_[arc.target] = d;
+                    witnessQueue_.push(arc.target, d);
+                }
+            }
+        }
+    }
+
+    // Insert u -> w, or lower the weight of an existing arc between them
+    void addArc(int u, int w, Weight weight, int middle) {
+        for (ChArc& arc : out_[u]) {
+            if (arc.target == w) {
+                if (weight < arc.weight) {
+                    arc.weight = weight;
+                    arc.middle = middle;
+                    for (ChArc& back : in_[w]) {
+                        if (back.target == u) {
+                            back.weight = weight;
+                            back.middle = middle;
+                        }
+                    }
+                }
+                return;
+            }
+        }
+        out_[u].push_back({w, weight, middle});
+        in_[w].push_back({u, weight, middle});
+    }
+
+    static void removeArc(std::vector<ChArc>& arcs, int target) {
+        for (size_t i = 0; i < arcs.size(); ++i) {
+            if (arcs[i].target == target) {
+                arcs[i] = arcs.back();
+                arcs.pop_back();
+                return;
+            }
+        }
+    }
+
+    // Estimating a priority tolerates a few extra shortcuts; the real contraction searches further
+    static const int SIMULATE_SETTLE_LIMIT = 50;
+    static const int CONTRACT_SETTLE_LIMIT = 500;
+
+    std::vector<std::vector<ChArc>> out_;  // remaining arcs u -> target
+    std::vector<std::vector<ChArc>> in_;   // remaining arcs target -> u
+    std::vector<bool> contracted_;
+    std::vector<int> contractedNeighbours_;
+    std::vector<Weight> witnessDist_;
+    std::vector<int> witnessTouched_;
+    std::vector<bool> isTarget_;  // out-neighbours of the vertex being contracted
+    IndexedDaryHeap<4> witnessQueue_;
+    long long shortcutsAdded_ = 0;
+};
+
+// Hierarchy built in memory; save() writes the index file that
+// MappedContractionHierarchy loads
+class ContractionHierarchy {
+public:
+    static ContractionHierarchy build(const CsrGraph& graph) {
+        int V = graph.numVertices();
+        std::vector<std::vector<ChArc>> forward(V);
+        std::vector<std::vector<ChArc>> backward(V);
+        ChContractor contractor(graph);
+        contractor.run(forward, backward);
+
+        ContractionHierarchy ch;
+        ch.shortcuts_ = contractor.shortcutsAdded();
+        flatten(forward, ch.forwardOffsets_, ch.forwardArcs_);
+        flatten(backward, ch.backwardOffsets_, ch.backwardArcs_);
+        return ch;
+    }
+
+    ChView view() const {
+        ChView v;
+        v.numVertices = static_cast<int>(forwardOffsets_.size()) - 1;
+        v.forwardOffsets = forwardOffsets_.data();
+        v.forwardArcs = forwardArcs_.data();
+        v.backwardOffsets = backwardOffsets_.data();
+        v.backwardArcs = backwardArcs_.data();
+        return v;
+    }
+
+    long long numShortcuts() const { return shortcuts_; }
+    size_t numArcs() const { return forwardArcs_.size() + backwardArcs_.size(); }
+
+    // Throws std::runtime_error if the file cannot be written
+    void save(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot create " + path);
+        }
+        ChFileHeader header = {};
+        std::memcpy(header.magic, CH_MAGIC, sizeof(header.magic));
+        header.weightBytes = sizeof(Weight);
+        header.arcBytes = sizeof(ChArc);
+        header.vertices = forwardOffsets_.size() - 1;
+        header.forwardArcs = forwardArcs_.size();
+        header.backwardArcs = backwardArcs_.size();
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeArray(out, forwardOffsets_);
+        writeArray(out, backwardOffsets_);
+        writeArray(out, forwardArcs_);
+        writeArray(out, backwardArcs_);
+        if (!out.flush()) {
+            throw std::runtime_error("Write failed for " + path);
+        }
+    }
+
+private:
+    static void flatten(const std::vector<std::vector<ChArc>>& lists, std::vector<int>& offsets,
+                        std::vector<ChArc>& arcs) {
+        offsets.assign(1, 0);
+        for (const std::vector<ChArc>& list : lists) {
+            arcs.insert(arcs.end(), list.begin(), list.end());
+            offsets.push_back(static_cast<int>(arcs.size()));
+        }
+    }
+
+    template <typename T>
+    static void writeArray(std::ofstream& out, const std::vector<T>& values) {
+        out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+    std::vector<int> forwardOffsets_;
+    std::vector<ChArc> forwardArcs_;
+    std::vector<int> backwardOffsets_;
+    std::vector<ChArc> backwardArcs_;
+    long long shortcuts_ = 0;
+};
+
+// Index file mapped read-only. The arrays are used in place, so opening costs
+// a header check and an O(V) scan of the offsets, independent of the arc count;
+// pages are faulted in as queries touch them.
+class MappedContractionHierarchy {
+public:
+    // Throws std::runtime_error if the file is missing, truncated or not an index
+    explicit MappedContractionHierarchy(const std::string& path) : path_(path) {
+#if DIJKSTRA_HAS_MMAP
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd_ < 0 || ::fstat(fd_, &info) != 0) {
+            fail("cannot open");
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ < sizeof(ChFileHeader)) {
+            fail("file too short");
+        }
+        void* base = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (base == MAP_FAILED) {
+            fail("cannot map");
+        }
+        data_ = static_cast<const char*>(base);
+        // Queries jump around the hierarchy
+        ::madvise(base, size_, MADV_RANDOM);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            fail("cannot open");
+        }
+        size_ = static_cast<size_t>(in.tellg());
+        if (size_ < sizeof(ChFileHeader)) {
+            fail("file too short");
+        }
+        buffer_.resize((size_ + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(size_));
+        data_ = reinterpret_cast<const char*>(buffer_.data());
+#endif
+        validate();
+    }
+
+    MappedContractionHierarchy(const MappedContractionHierarchy&) = delete;
+    MappedContractionHierarchy& operator=(const MappedContractionHierarchy&) = delete;
+
+    ~MappedContractionHierarchy() { release(); }
+
+    const ChView& view() const { return view_; }
+    size_t fileBytes() const { return size_; }
+
+private:
+    void validate() {
+        ChFileHeader header;
+        std::memcpy(&header, data_, sizeof(header));
+        if (std::memcmp(header.magic, CH_MAGIC, sizeof(header.magic)) != 0) {
+            fail("not a contraction hierarchy index");
+        }
+        if (header.weightBytes != sizeof(Weight) || header.arcBytes != sizeof(ChArc)) {
+            fail("index was built with a different weight type");
+        }
+        uint64_t V = header.vertices;
+        uint64_t expected = sizeof(ChFileHeader) + 2 * (V + 1) * sizeof(int) +
+                            (header.forwardArcs + header.backwardArcs) * sizeof(ChArc);
+        if (V >= static_cast<uint64_t>(std::numeric_limits<int>::max()) || size_ != expected) {
+            fail("size does not match header");
+        }
+
+        const char* p = data_ + sizeof(ChFileHeader);
+        view_.numVertices = static_cast<int>(V);
+        view_.forwardOffsets = reinterpret_cast<const int*>(p);
+        p += (V + 1) * sizeof(int);
+        view_.backwardOffsets = reinterpret_cast<const int*>(p);
+        p += (V + 1) * sizeof(int);
+        view_.forwardArcs = reinterpret_cast<const ChArc*>(p);
+        p += header.forwardArcs * sizeof(ChArc);
+        view_.backwardArcs = reinterpret_cast<const ChArc*>(p);
+
+        // A corrupt offset would send a query outside the mapping
+        if (!offsetsValid(view_.forwardOffsets, header.forwardArcs) ||
+            !offsetsValid(view_.backwardOffsets, header.backwardArcs)) {
+            fail("corrupt offsets");
+        }
+    }
+
+    bool offsetsValid(const int* offsets, uint64_t arcs) const {
+        if (offsets[0] != 0 || static_cast<uint64_t>(offsets[view_.numVertices]) != arcs) {
+            return false;
+        }
+        for (int v = 0; v < view_.numVertices; ++v) {
+            if (offsets[v] > offsets[v + 1]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[noreturn]] void fail(const char* reason) {
+        release();
+        throw std::runtime_error("Cannot load " + path_ + ": " + reason);
+    }
+
+    void release() {
+#if DIJKSTRA_HAS_MMAP
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+            data_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+#endif
+    }
+
+    std::string path_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    ChView view_;
+#if DIJKSTRA_HAS_MMAP
+    int fd_ = -1;
+#else
+    std::vector<uint64_t> buffer_;  // 8-byte aligned copy of the file
+#endif
+};
+
+// s-t queries over a hierarchy: two upward searches that meet at the
+// highest-ranked vertex of the shortest path. Each side stops once its
+// smallest key reaches the best meeting distance found so far. The view's
+// owner (ContractionHierarchy or MappedContractionHierarchy) must outlive it.
+//
+// Stall-on-demand: a vertex u reached with a distance that some higher-ranked
+// neighbour already beats (through an arc pointing down into u) cannot lie on
+// a shortest up-path, so its arcs are not relaxed. This prunes most of the
+// search space the upward restriction alone would still explore.
+class ChQueryEngine {
+public:
+    explicit ChQueryEngine(const ChView& ch) : ch_(ch), forward_(ch.numVertices), backward_(ch.numVertices) {}
+
+    // Distance only, skipping path unpacking; INF if t is unreachable
+    Weight distance(int s, int t) {
+        Weight best = INF;
+        int settled = 0;
+        search(s, t, best, settled);
+        return best;
+    }
+
+    PointToPoint query(int s, int t) {
+        PointToPoint answer;
+        Weight best = INF;
+        int meet = search(s, t, best, answer.settled);
+        if (meet < 0) {
+            return answer;
+        }
+
+        answer.distance = best;
+        // Up-path s -> meet and down-path meet -> t in hierarchy arcs, then unpack shortcuts
+        std::vector<int> up;
+        for (int v = meet; v != -1; v = forward_.pred[v]) {
+            up.push_back(v);
+        }
+        std::reverse(up.begin(), up.end());
+        answer.path.push_back(s);
+        for (size_t i = 0; i + 1 < up.size(); ++i) {
+            unpack(up[i], up[i + 1], answer.path);
+        }
+        for (int v = meet; backward_.pred[v] != -1; v = backward_.pred[v]) {
+            unpack(v, backward_.pred[v], answer.path);
+        }
+        return answer;
+    }
+
+private:
+    // Run both upward searches; returns the meeting vertex, or -1 if t is unreachable
+    int search(int s, int t, Weight& best, int& settled) {
+        if (s < 0 || s >= ch_.numVertices || t < 0 || t >= ch_.numVertices) {
+            throw std::invalid_argument("Query vertex out of range");
+        }
+        forward_.start(s);
+        backward_.start(t);
+
+        int meet = -1;
+        while (true) {
+            bool forwardLive = !forward_.queue.empty() && forward_.queue.top().first < best;
+            bool backwardLive = !backward_.queue.empty() && backward_.queue.top().first < best;
+            if (!forwardLive && !backwardLive) {
+                break;
+            }
+            if (forwardLive && (!backwardLive || forward_.queue.top().first <= backward_.queue.top().first)) {
+                step(forward_, backward_, ch_.forwardOffsets, ch_.forwardArcs, ch_.backwardOffsets, ch_.backwardArcs,
+                     best, meet);
+            } else {
+                step(backward_, forward_, ch_.backwardOffsets, ch_.backwardArcs, ch_.forwardOffsets, ch_.forwardArcs,
+                     best, meet);
+            }
+            settled++;
+        }
+        return meet;
+    }
+
+    // State of one direction, reset per query through `touched`
+    struct Search {
+        explicit Search(int vertices) : dist(vertices, INF), pred(vertices, -1) { queue.resize(vertices); }
+
+        void start(int src) {
+            for (int v : touched) {
+                dist[v] = INF;
+                pred[v] = -1;
+            }
+            touched.clear();
+            queue.clear();
+            dist[src] = 0;
+            touched.push_back(src);
+            queue.push(src, 0);
+        }
+
+        std::vector<Weight> dist;
+        std::vector<int> pred;
+        std::vector<int> touched;
+        IndexedDaryHeap<4> queue;
+    };
+
+    // Settle the closest vertex of `self`: relax its upward arcs unless one of
+    // its downward arcs (the other direction's list) proves it is stalled
+    static void step(Search& self, const Search& other, const int* offsets, const ChArc* arcs,
+                     const int* downOffsets, const ChArc* downArcs, Weight& best, int& meet) {
+        int u = self.queue.pop().second;
+        Weight du = self.dist[u];
+        if (addWeights(du, other.dist[u]) < best) {
+            best = addWeights(du, other.dist[u]);
+            meet = u;
+        }
+        for (int e = downOffsets[u]; e < downOffsets[u + 1]; ++e) {
+            Weight dx = self.dist[downArcs[e].target];
+            if (addWeights(dx, downArcs[e].weight) < du) {
+                return;
+            }
+        }
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            int v = arcs[e].target;
+            Weight d = addWeights(du, arcs[e].weight);
+            if (d < self.dist[v]) {
+                if (self.dist[v] == INF) {
+                    self.touched.push_back(v);
+                }
+                self.dist[v] = d;
+                self.pred[v] = u;
+                self.queue.push(v, d);
+            }
+        }
+    }
+
+    // Append the original vertices of arc u -> v (excluding u) to path
+    void unpack(int u, int v, std::vector<int>& path) const {
+        int middle = arcBetween(u, v).middle;
+        if (middle < 0) {
+            path.push_back(v);
+            return;
+        }
+        unpack(u, middle, path);
+        unpack(middle, v, path);
+    }
+
+    // The hierarchy arc from u to v: stored at the lower-ranked endpoint, as a
+    // forward arc of u or a backward arc of v
+    const ChArc& arcBetween(int u, int v) const {
+        for (int e = ch_.forwardOffsets[u]; e < ch_.forwardOffsets[u + 1]; ++e) {
+            if (ch_.forwardArcs[e].target == v) {
+                return ch_.forwardArcs[e];
+            }
+        }
+        for (int e = ch_.backwardOffsets[v]; e < ch_.backwardOffsets[v + 1]; ++e) {
+            if (ch_.backwardArcs[e].target == u) {
+                return ch_.backwardArcs[e];
+            }
+        }
+        throw std::runtime_error("Contraction hierarchy is missing an arc");
+    }
+
+    ChView ch_;
+    Search forward_;
+    Search backward_;
+};
+
+// -------------------------------------------------------------------------------------
+// Parallel delta-stepping
+// -------------------------------------------------------------------------------------
+
+// Fixed set of worker threads that run one parallel loop at a time. The calling
+// thread takes part as worker 0, so ThreadPool(1) spawns nothing and runs inline.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads) {
+        for (int i = 1; i < std::max(1, threads); ++i) {
+            workers_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+    // Run fn(begin, end, worker) over [0, n) in chunks of `grain`, handed out
+    // dynamically so high-degree vertices do not stall one thread. Returns once
+    // every chunk is done. Small loops run inline on the calling thread.
+    template <typename Fn>
+    void parallelFor(int n, int grain, Fn&& fn) {
+        if (n <= grain || workers_.empty()) {
+            if (n > 0) {
+                fn(0, n, 0);
+            }
+            return;
+        }
+        std::atomic<int> next(0);
+        runOnAll([&](int worker) {
+            for (int begin = next.fetch_add(grain); begin < n; begin = next.fetch_add(grain)) {
+                fn(begin, std::min(begin + grain, n), worker);
+            }
+        });
+    }
+
+private:
+    void runOnAll(const std::function<void(int)>& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &job;
+            pending_ = static_cast<int>(workers_.size());
+            generation_++;
+        }
+        wake_.notify_all();
+        job(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+    void workerLoop(int index) {
+        unsigned long seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            const std::function<void(int)>* job = job_;
+            lock.unlock();
+            (*job)(index);
+            lock.lock();
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(int)>* job_ = nullptr;
+    unsigned long generation_ = 0;
+    int pending_ = 0;
+    bool stop_ = false;
+};
+
+// Delta-stepping (Meyer and Sanders): tentative distances are grouped into
+// buckets of width delta. Bucket i is emptied in phases that relax the light
+// edges (weight <= delta) of all its vertices in parallel, since those can only
+// feed bucket i again; once it stays empty the heavy edges of everything it
+// settled are relaxed in one more parallel pass. delta = 1 degenerates to Dial's
+// algorithm and delta = infinity to Bellman-Ford; in between, each phase has
+// enough independent work to keep the threads busy.
+//
+// Distances are exact and identical to sequential Dijkstra. Predecessors are
+// rebuilt deterministically after the search (the smallest tight in-neighbour),
+// so they form a valid shortest-path tree but may pick a different one of
+// several equally short routes than the heap-based engine does.
+//
+// The buckets form a circular window of min(maxWeight / delta + 2, V + 1)
+// slots, so memory follows the graph size whatever delta the caller picks.
+// Vertices whose bucket lies beyond the window wait in an overflow list and
+// are moved in once the window reaches them; when the window runs empty the
+// search jumps straight to the nearest overflow bucket.
+class DeltaSteppingEngine {
+public:
+    // delta 0 picks maxWeight / average degree, a common rule of thumb
+    DeltaSteppingEngine(const CsrGraph& graph, ThreadPool& pool, Weight delta = 0)
+        : graph_(graph), pool_(pool), dist_(graph.numVertices()), stamp_(graph.numVertices(), 0),
+          touchedStamp_(graph.numVertices(), 0), outbox_(pool.size()), predBuffer_(graph.numVertices()) {
+        if (delta == 0) {
+            double degree = graph.numVertices() > 0 ? double(graph.numEdges()) / graph.numVertices() : 1.0;
+            delta = static_cast<Weight>(graph.maxWeight() / std::max(1.0, degree));
+        }
+        delta_ = std::max<Weight>(1, delta);
+        // Live distances span at most maxWeight above the current bucket, so that
+        // many buckets never wrap onto a live one; a small delta against large
+        // weights would need far more, so the window stops at V + 1 slots
+        size_t span = static_cast<size_t>(graph.maxWeight() / delta_) + 2;
+        buckets_.resize(std::min(span, static_cast<size_t>(graph.numVertices()) + 1));
+        result_.dist.assign(graph.numVertices(), INF);
+        result_.pred.assign(graph.numVertices(), -1);
+        for (std::atomic<Weight>& d : dist_) {
+            d.store(INF, std::memory_order_relaxed);
+        }
+    }
+
+    // Run from src. The returned reference stays valid until the next call.
+    const ShortestPaths& run(int src) {
+        if (src < 0 || src >= graph_.numVertices()) {
+            throw std::invalid_argument("Source vertex out of range");
+        }
+        reset();
+
+        dist_[src].store(0, std::memory_order_relaxed);
+        markTouched(src);
+        buckets_[0].push_back(src);
+        size_t queued = 1;
+
+        for (size_t index = 0; queued > 0; ++index) {
+            if (!overflow_.empty()) {
+                // Everything left is beyond the window: skip the empty buckets in between
+                if (queued == overflow_.size()) {
+                    index = std::max(index, overflowMin_);
+                }
+                if (overflowMin_ < index + buckets_.size()) {
+                    queued -= drainOverflow(index);
+                }
+            }
+            window_ = index;
+            std::vector<int>& bucket = buckets_[index % buckets_.size()];
+            settledHere_.clear();
+
+            // Light phases: repeat until relaxations stop refilling this bucket
+            while (!bucket.empty()) {
+                queued -= bucket.size();
+                stampEpoch_++;
+                frontier_.clear();
+                for (int v : bucket) {
+                    Weight d = dist_[v].load(std::memory_order_relaxed);
+                    // Skip stale entries and duplicates within the phase
+                    if (bucketOf(d) == index && stamp_[v] != stampEpoch_) {
+                        stamp_[v] = stampEpoch_;
+                        frontier_.push_back(v);
+                    }
+                }
+                bucket.clear();
+                settledHere_.insert(settledHere_.end(), frontier_.begin(), frontier_.end());
+                relaxFrontier(frontier_, true);
+                queued += collectOutboxes();
+            }
+
+            // Heavy edges of every vertex settled in this bucket
+            relaxFrontier(settledHere_, false);
+            queued += collectOutboxes();
+        }
+
+        finish(src);
+        return result_;
+    }
+
+    Weight delta() const { return delta_; }
+
+private:
+    size_t bucketOf(Weight d) const { return static_cast<size_t>(d / delta_); }
+
+    // Lower dist[v] to d if that is an improvement; true if this call lowered it
+    bool relaxTo(int v, Weight d) {
+        Weight current = dist_[v].load(std::memory_order_relaxed);
+        while (d < current) {
+            if (dist_[v].compare_exchange_weak(current, d, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void relaxFrontier(const std::vector<int>& frontier, bool light) {
+        pool_.parallelFor(static_cast<int>(frontier.size()), 64, [&](int begin, int end, int worker) {
+            std::vector<int>& outbox = outbox_[worker];
+            for (int i = begin; i < end; ++i) {
+                int u = frontier[i];
+                Weight du = dist_[u].load(std::memory_order_relaxed);
+                for (int e = graph_.edgesBegin(u); e < graph_.edgesEnd(u); ++e) {
+                    Weight w = graph_.weight(e);
+                    if ((w <= delta_) == light && relaxTo(graph_.target(e), addWeights(du, w))) {
+                        outbox.push_back(graph_.target(e));
+                    }
+                }
+            }
+        });
+    }
+
+    // Move every improved vertex into the bucket of its final distance for this
+    // phase, or into the overflow list if that bucket is past the window. The
+    // thread pool's join orders this after all relaxations.
+    size_t collectOutboxes() {
+        size_t added = 0;
+        for (std::vector<int>& outbox : outbox_) {
+            for (int v : outbox) {
+                markTouched(v);
+                enqueue(v, bucketOf(dist_[v].load(std::memory_order_relaxed)));
+                added++;
+            }
+            outbox.clear();
+        }
+        return added;
+    }
+
+    void enqueue(int v, size_t bucket) {
+        if (bucket < window_ + buckets_.size()) {
+            buckets_[bucket % buckets_.size()].push_back(v);
+        } else {
+            overflow_.push_back(v);
+            overflowMin_ = std::min(overflowMin_, bucket);
+        }
+    }
+
+    // Bring overflow entries that now fall inside the window starting at index
+    // into their buckets. Entries whose vertex has since been lowered into an
+    // already emptied bucket are stale and dropped; returns how many were.
+    size_t drainOverflow(size_t index) {
+        window_ = index;
+        std::vector<int> pending;
+        pending.swap(overflow_);
+        overflowMin_ = std::numeric_limits<size_t>::max();
+        size_t dropped = 0;
+        for (int v : pending) {
+            size_t bucket = bucketOf(dist_[v].load(std::memory_order_relaxed));
+            if (bucket < index) {
+                dropped++;
+            } else {
+                enqueue(v, bucket);
+            }
+        }
+        return dropped;
+    }
+
+    // Record v for the next reset the first time this query reaches it
+    void markTouched(int v) {
+        if (touchedStamp_[v] != queryEpoch_) {
+            touchedStamp_[v] = queryEpoch_;
+            touched_.push_back(v);
+        }
+    }
+
+    // Copy distances out and choose each vertex's predecessor
+    void finish(int src) {
+        const int n = static_cast<int>(touched_.size());
+        pool_.parallelFor(n, 1024, [&](int begin, int end, int) {
+            for (int i = begin; i < end; ++i) {
+                int v = touched_[i];
+                result_.dist[v] = dist_[v].load(std::memory_order_relaxed);
+            }
+        });
+
+        // Each reached u offers itself to every out-neighbour it is tight for;
+        // the smallest id wins. Zero-weight ties could form a cycle this way, so
+        // only positive edges are used here and those are repaired below.
+        pool_.parallelFor(n, 1024, [&](int begin, int end, int) {
+            for (int i = begin; i < end; ++i) {
+                predBuffer_[touched_[i]].store(-1, std::memory_order_relaxed);
+            }
+        });
+        std::atomic<bool> zeroTies(false);
+        pool_.parallelFor(n, 256, [&](int begin, int end, int) {
+            bool sawZero = false;
+            for (int i = begin; i < end; ++i) {
+                int u = touched_[i];
+                Weight du = result_.dist[u];
+                for (int e = graph_.edgesBegin(u); e < graph_.edgesEnd(u); ++e) {
+                    int v = graph_.target(e);
+                    Weight w = graph_.weight(e);
+                    if (addWeights(du, w) != result_.dist[v] || v == src) {
+                        continue;
+                    }
+                    if (w == 0) {
+                        sawZero = true;
+                        continue;
+                    }
+                    int current = predBuffer_[v].load(std::memory_order_relaxed);
+                    while ((current == -1 || u < current) &&
+                           !predBuffer_[v].compare_exchange_weak(current, u, std::memory_order_relaxed)) {
+                    }
+                }
+            }
+            if (sawZero) {
+                zeroTies.store(true, std::memory_order_relaxed);
+            }
+        });
+        pool_.parallelFor(n, 1024, [&](int begin, int end, int) {
+            for (int i = begin; i < end; ++i) {
+                int v = touched_[i];
+                result_.pred[v] = predBuffer_[v].load(std::memory_order_relaxed);
+            }
+        });
+
+        if (zeroTies) {
+            attachZeroWeightTies(src);
+        }
+    }
+
+    // Vertices reachable only through zero-weight tight edges still lack a
+    // predecessor; a BFS along those edges from the attached vertices fixes them
+    void attachZeroWeightTies(int src) {
+        std::vector<int> queue;
+        for (int v : touched_) {
+            if (v == src || result_.pred[v] != -1) {
+                queue.push_back(v);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int u = queue[head];
+            for (int e = graph_.edgesBegin(u); e < graph_.edgesEnd(u); ++e) {
+                int v = graph_.target(e);
+                if (graph_.weight(e) == 0 && v != src && result_.pred[v] == -1 && result_.dist[v] == result_.dist[u]) {
+                    result_.pred[v] = u;
+                    queue.push_back(v);
+                }
+            }
+        }
+    }
+
+    // Restore only the entries the previous query wrote
+    void reset() {
+        for (int v : touched_) {
+            dist_[v].store(INF, std::memory_order_relaxed);
+            result_.dist[v] = INF;
+            result_.pred[v] = -1;
+        }
+        touched_.clear();
+        queryEpoch_++;
+        overflow_.clear();
+        overflowMin_ = std::numeric_limits<size_t>::max();
+        window_ = 0;
+    }
+
+    const CsrGraph& graph_;
+    ThreadPool& pool_;
+    Weight delta_;
+    std::vector<std::atomic<Weight>> dist_;
+    std::vector<std::vector<int>> buckets_;    // circular, indexed by dist / delta
+    size_t window_ = 0;                        // first bucket index the circular array holds
+    std::vector<int> overflow_;                // vertices whose bucket lies past the window
+    size_t overflowMin_ = std::numeric_limits<size_t>::max();
+    std::vector<unsigned> stamp_;              // phase in which v last joined a frontier
+    unsigned stampEpoch_ = 0;
+    std::vector<unsigned> touchedStamp_;       // query in which v was first reached
+    unsigned queryEpoch_ = 0;
+    std::vector<std::vector<int>> outbox_;     // per-worker improved vertices
+    std::vector<std::atomic<int>> predBuffer_; // smallest tight in-neighbour so far
+    std::vector<int> frontier_;
+    std::vector<int> settledHere_;
+    std::vector<int> touched_;
+    ShortestPaths result_;
+};
+
+// One-off parallel query; prefer a DeltaSteppingEngine for repeated queries
+ShortestPaths deltaStepping(const CsrGraph& graph, int src, int threads, Weight delta = 0) {
+    ThreadPool pool(threads);
+    DeltaSteppingEngine engine(graph, pool, delta);
+    return engine.run(src);
+}
+
+// -------------------------------------------------------------------------------------
+// Batched queries
+// -------------------------------------------------------------------------------------
+
+// Result of a nearest-facility query
+struct FacilityAssignment {
+    std::vector<Weight> dist;   // distance from the nearest facility, INF if none reaches v
+    std::vector<int> facility;  // index into the facilities list, -1 if unreachable
+};
+
+// One multi-source run from every facility at once instead of one run each.
+// Distances are measured from the facilities along the arcs; to measure towards
+// them on a directed graph, bind the engine to graph.reversed().
+template <template <typename> class Queue>
+FacilityAssignment nearestFacilities(DijkstraEngine<Weight, Queue>& engine, const std::vector<int>& facilities) {
+    const ShortestPaths& paths = engine.run(facilities);
+    int V = static_cast<int>(paths.dist.size());
+
+    FacilityAssignment result;
+    result.dist = paths.dist;
+    result.facility.assign(V, -1);
+    for (int i = static_cast<int>(facilities.size()) - 1; i >= 0; --i) {
+        result.facility[facilities[i]] = i;  // first listed wins for duplicates
+    }
+
+    // Each predecessor chain ends at the facility that reached v first; walk up
+    // to a vertex already labelled, then label the whole chain on the way back
+    std::vector<int> chain;
+    for (int v = 0; v < V; ++v) {
+        if (paths.dist[v] == INF || result.facility[v] != -1) {
+            continue;
+        }
+        int u = v;
+        while (result.facility[u] == -1) {
+            chain.push_back(u);
+            u = paths.pred[u];
+        }
+        for (int w : chain) {
+            result.facility[w] = result.facility[u];
+        }
+        chain.clear();
+    }
+    return result;
+}
+
+// Row-major |sources| x |targets| table of distances
+struct DistanceMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<Weight> values;
+
+    Weight at(int row, int col) const { return values[static_cast<size_t>(row) * cols + col]; }
+};
+
+// Many-to-many distances: one early-exit search per source, spread over a
+// thread pool. Each worker owns a DijkstraEngine whose distance, predecessor
+// and heap buffers are reused for every source it handles (and across calls),
+// and each search stops as soon as its last target is settled.
+class ManyToManyEngine {
+public:
+    ManyToManyEngine(const CsrGraph& graph, ThreadPool& pool)
+        : graph_(graph), pool_(pool), engines_(pool.size()), isTarget_(graph.numVertices(), 0) {}
+
+    DistanceMatrix compute(const std::vector<int>& sources, const std::vector<int>& targets) {
+        DistanceMatrix matrix;
+        matrix.rows = static_cast<int>(sources.size());
+        matrix.cols = static_cast<int>(targets.size());
+        matrix.values.assign(static_cast<size_t>(matrix.rows) * matrix.cols, INF);
+
+        // Validate up front: workers must not throw
+        for (int s : sources) {
+            if (s < 0 || s >= graph_.numVertices()) {
+                throw std::invalid_argument("Source vertex out of range");
+            }
+        }
+        for (int t : targets) {
+            if (t < 0 || t >= graph_.numVertices()) {
+                throw std::invalid_argument("Target vertex out of range");
+            }
+        }
+
+        int distinctTargets = 0;
+        for (int t : targets) {
+            if (!isTarget_[t]) {
+                isTarget_[t] = 1;
+                distinctTargets++;
+            }
+        }
+
+        pool_.parallelFor(matrix.rows, 1, [&](int begin, int end, int worker) {
+            if (!engines_[worker]) {
+                engines_[worker].reset(new DijkstraEngine<>(graph_));
+            }
+            DijkstraEngine<>& engine = *engines_[worker];
+            for (int row = begin; row < end; ++row) {
+                int remaining = distinctTargets;
+                const ShortestPaths& paths = engine.runUntil(sources[row], [&](int u) {
+                    return isTarget_[u] && --remaining == 0;
+                });
+                Weight* out = matrix.values.data() + static_cast<size_t>(row) * matrix.cols;
+                for (int col = 0; col < matrix.cols; ++col) {
+                    out[col] = paths.dist[targets[col]];
+                }
+            }
+        });
+
+        for (int t : targets) {
+            isTarget_[t] = 0;
+        }
+        return matrix;
+    }
+
+private:
+    const CsrGraph& graph_;
+    ThreadPool& pool_;
+    std::vector<std::unique_ptr<DijkstraEngine<>>> engines_;  // per-worker scratch, created on first use
+    std::vector<char> isTarget_;                              // read-only while workers run
+};
+
+// One-off many-to-many table; prefer a ManyToManyEngine for repeated batches
+DistanceMatrix manyToMany(const CsrGraph& graph, const std::vector<int>& sources, const std::vector<int>& targets,
+                          int threads) {
+    ThreadPool pool(threads);
+    ManyToManyEngine engine(graph, pool);
+    return engine.compute(sources, targets);
+}
+
+// -------------------------------------------------------------------------------------
+// Dynamic updates
+// -------------------------------------------------------------------------------------
+
+// Single-source shortest paths kept up to date while arc weights change.
+// The topology comes from the graph and stays fixed; the weights are copied and
+// owned here, so update() can move them around without rebuilding the CSR.
+//
+// A batch is repaired in two steps, in the spirit of Ramalingam and Reps:
+// 1. Every vertex below an increased tree arc may have lost its route, so the
+//    subtrees hanging off those arcs are invalidated and each of their vertices
+//    is re-seeded with the best distance offered by an in-neighbour outside them.
+// 2. A Dijkstra pass starting from those seeds and from the heads of decreased
+//    arcs propagates improvements only as far as distances actually change.
+// Work is bounded by the invalidated subtrees, the vertices whose distance
+// changes, and their arcs, not by the size of the graph.
+class DynamicShortestPaths {
+public:
+    // Computes the initial tree from src with a full Dijkstra pass
+    DynamicShortestPaths(const CsrGraph& graph, int src)
+        : graph_(graph), src_(src), inOffsets_(graph.numVertices() + 1, 0), affected_(graph.numVertices(), 0),
+          arcChanged_(graph.numEdges(), 0) {
+        if (src < 0 || src >= graph.numVertices()) {
+            throw std::invalid_argument("Source vertex out of range");
+        }
+        int V = graph.numVertices();
+
+        // Own copy of the weights, plus the in-arcs of every vertex as {tail, arc}
+        // so invalidated vertices can look for a new parent
+        weights_.resize(graph.numEdges());
+        for (int u = 0; u < V; ++u) {
+            for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e) {
+                weights_[e] = graph.weight(e);
+                inOffsets_[graph.target(e) + 1]++;
+            }
+        }
+        for (int v = 0; v < V; ++v) {
+            inOffsets_[v + 1] += inOffsets_[v];
+        }
+        inArcs_.resize(graph.numEdges());
+        std::vector<int> next(inOffsets_.begin(), inOffsets_.end() - 1);
+        for (int u = 0; u < V; ++u) {
+            for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e) {
+                inArcs_[next[graph.target(e)]++] = {u, e};
+            }
+        }
+
+        result_.dist.assign(V, INF);
+        result_.pred.assign(V, -1);
+        predArc_.assign(V, -1);
+        queue_.resize(V);
+        setDistance(src, 0, -1, -1);
+        queue_.push(src, 0);
+        propagate();
+    }
+
+    // Apply a batch of new weights and repair the tree. Each change gives the
+    // new weight of every arc from -> to; an undirected edge is two arcs, so
+    // change both. The whole batch is validated before anything is applied:
+    // throws std::invalid_argument for a missing arc or a negative weight.
+    const ShortestPaths& update(const std::vector<Edge>& changes) {
+        for (const Edge& change : changes) {
+            if (change.from < 0 || change.from >= graph_.numVertices() || change.to < 0 ||
+                change.to >= graph_.numVertices()) {
+                throw std::invalid_argument("Edge endpoint out of range");
+            }
+            if (!isValidWeight(change.weight)) {
+                throw std::invalid_argument("Dijkstra requires non-negative edge weights");
+            }
+            if (findArc(change.from, change.to) < 0) {
+                throw std::invalid_argument("No arc from " + std::to_string(change.from) + " to " +
+                                            std::to_string(change.to));
+            }
+        }
+        repaired_ = 0;
+
+        // Record each arc's weight before the batch, so an arc changed twice is
+        // judged by its net change
+        for (const Edge& change : changes) {
+            for (int e = graph_.edgesBegin(change.from); e < graph_.edgesEnd(change.from); ++e) {
+                if (graph_.target(e) != change.to) {
+                    continue;
+                }
+                if (!arcChanged_[e]) {
+                    arcChanged_[e] = 1;
+                    changed_.push_back({change.from, e, weights_[e]});
+                }
+                weights_[e] = change.weight;
+            }
+        }
+
+        // Step 1: invalidate the subtrees below increased tree arcs
+        for (const ArcChange& change : changed_) {
+            int v = graph_.target(change.arc);
+            if (weights_[change.arc] > change.oldWeight && predArc_[v] == change.arc && !affected_[v]) {
+                invalidateSubtree(v);
+            }
+        }
+        for (int v : invalid_) {
+            result_.dist[v] = INF;
+            result_.pred[v] = -1;
+            predArc_[v] = -1;
+        }
+        for (int v : invalid_) {
+            for (int i = inOffsets_[v]; i < inOffsets_[v + 1]; ++i) {
+                const InArc& in = inArcs_[i];
+                if (affected_[in.from]) {
+                    continue;
+                }
+                Weight candidate = addWeights(result_.dist[in.from], weights_[in.arc]);
+                if (candidate < result_.dist[v]) {
+                    setDistance(v, candidate, in.from, in.arc);
+                }
+            }
+            if (result_.dist[v] != INF) {
+                queue_.push(v, result_.dist[v]);
+            }
+        }
+
+        // Step 2: seed the heads of decreased arcs, then propagate
+        for (const ArcChange& change : changed_) {
+            if (weights_[change.arc] < change.oldWeight) {
+                relax(change.from, change.arc);
+            }
+            arcChanged_[change.arc] = 0;
+        }
+        changed_.clear();
+        for (int v : invalid_) {
+            affected_[v] = 0;
+        }
+        repaired_ += static_cast<int>(invalid_.size());
+        invalid_.clear();
+        propagate();
+        return result_;
+    }
+
+    const ShortestPaths& paths() const { return result_; }
+    int source() const { return src_; }
+
+    // Current weight of arc e (an index into the graph's edge arrays)
+    Weight weight(int e) const { return weights_[e]; }
+
+    // Vertices invalidated or re-settled by the last update
+    int repairedCount() const { return repaired_; }
+
+private:
+    struct InArc {
+        int from;
+        int arc;
+    };
+
+    struct ArcChange {
+        int from;
+        int arc;
+        Weight oldWeight;
+    };
+
+    int findArc(int u, int v) const {
+        for (int e = graph_.edgesBegin(u); e < graph_.edgesEnd(u); ++e) {
+            if (graph_.target(e) == v) {
+                return e;
+            }
+        }
+        return -1;
+    }
+
+    // Mark root and every vertex whose tree path runs through it. Children are
+    // found through the out-arcs that are their predecessor arcs, so no child
+    // lists need to be maintained.
+    void invalidateSubtree(int root) {
+        affected_[root] = 1;
+        size_t first = invalid_.size();
+        invalid_.push_back(root);
+        for (size_t i = first; i < invalid_.size(); ++i) {
+            int x = invalid_[i];
+            for (int e = graph_.edgesBegin(x); e < graph_.edgesEnd(x); ++e) {
+                int y = graph_.target(e);
+                if (predArc_[y] == e && !affected_[y]) {
+                    affected_[y] = 1;
+                    invalid_.push_back(y);
+                }
+            }
+        }
+    }
+
+    void relax(int u, int e) {
+        int v = graph_.target(e);
+        Weight candidate = addWeights(result_.dist[u], weights_[e]);
+        if (candidate < result_.dist[v]) {
+            setDistance(v, candidate, u, e);
+            queue_.push(v, candidate);
+        }
+    }
+
+    // Dijkstra from whatever is queued. Every arc is either tight-or-better or
+    // has its tail in the queue, so on exit all distances are exact again.
+    void propagate() {
+        while (!queue_.empty()) {
+            int u = queue_.pop().second;
+            repaired_++;
+            for (int e = graph_.edgesBegin(u); e < graph_.edgesEnd(u); ++e) {
+                relax(u, e);
+            }
+        }
+    }
+
+    void setDistance(int v, Weight d, int parent, int arc) {
+        result_.dist[v] = d;
+        result_.pred[v] = parent;
+        predArc_[v] = arc;
+    }
+
+    const CsrGraph& graph_;
+    int src_;
+    std::vector<Weight> weights_;     // current weight of every arc
+    std::vector<int> inOffsets_;      // in-arcs of v are inArcs_[inOffsets_[v] .. inOffsets_[v + 1])
+    std::vector<InArc> inArcs_;
+    ShortestPaths result_;
+    std::vector<int> predArc_;        // arc into v on the tree, or -1
+    IndexedDaryHeap<4> queue_;
+    std::vector<char> affected_;      // in an invalidated subtree during update()
+    std::vector<int> invalid_;
+    std::vector<char> arcChanged_;    // arc already recorded in changed_
+    std::vector<ArcChange> changed_;
+    int repaired_ = 0;
+};
+
+// -------------------------------------------------------------------------------------
+// Benchmarks
+// -------------------------------------------------------------------------------------
+
+// Road-like test graph: a side x side grid with random weights in [1, maxWeight],
+// plus side * side / 8 random "highway" shortcuts, stored undirected
+CsrGraph makeGridGraph(int side, Weight maxWeight, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<Weight> weight(1, maxWeight);
+    int V = side * side;
+    std::vector<Edge> edges;
+    edges.reserve(2 * V + V / 8);
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int u = r * side + c;
+            if (c + 1 < side) edges.push_back({u, u + 1, weight(rng)});
+            if (r + 1 < side) edges.push_back({u, u + side, weight(rng)});
+        }
+    }
+    std::uniform_int_distribution<int> vertex(0, V - 1);
+    for (int i = 0; i < V / 8; ++i) {
+        edges.push_back({vertex(rng), vertex(rng), weight(rng)});
+    }
+    return CsrGraph::fromEdges(V, edges, true);
+}
+
+// Time the same single-source queries with every queue and check they agree
+void benchmarkQueues(const CsrGraph& graph, int queries, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<int> sources(queries);
+    for (int& s : sources) {
+        s = static_cast<int>(rng() % graph.numVertices());
+    }
+
+    std::cout << "Graph: " << graph.numVertices() << " vertices, " << graph.numEdges() << " arcs, max weight "
+              << graph.maxWeight() << "; " << queries << " queries\n";
+    std::cout << std::left << std::setw(22) << "Queue" << std::right << std::setw(14) << "ms/query"
+              << std::setw(12) << "vs lazy" << std::setw(10) << "Match" << "\n";
+
+    std::vector<std::vector<Weight>> reference;
+    double lazyMs = 0;
+    for (QueueKind kind : {QueueKind::Lazy, QueueKind::Dary, QueueKind::Radix, QueueKind::Dial}) {
+        withEngine(graph, kind, [&](auto& engine) {
+            bool match = true;
+            auto start = std::chrono::steady_clock::now();
+            for (int q = 0; q < queries; ++q) {
+                const ShortestPaths& paths = engine.run(sources[q]);
+                if (kind == QueueKind::Lazy) {
+                    reference.push_back(paths.dist);
+                } else {
+                    match = match && paths.dist == reference[q];
+                }
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / queries;
+            if (kind == QueueKind::Lazy) {
+                lazyMs = ms;
+            }
+            std::cout << std::left << std::setw(22) << queueName(kind) << std::right << std::fixed
+                      << std::setprecision(2) << std::setw(14) << ms << std::setw(11) << lazyMs / ms << "x"
+                      << std::setw(10) << (match ? "yes" : "NO") << "\n";
+        });
+    }
+}
+
+// Copy of graph with its weights converted to W
+template <typename W>
+BasicCsrGraph<W> withWeightType(const CsrGraph& graph) {
+    std::vector<BasicEdge<W>> edges;
+    edges.reserve(graph.numEdges());
+    for (int u = 0; u < graph.numVertices(); ++u) {
+        for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e) {
+            edges.push_back({u, graph.target(e), static_cast<W>(graph.weight(e))});
+        }
+    }
+    return BasicCsrGraph<W>::fromEdges(graph.numVertices(), edges, false);
+}
+
+// Time the same queries with 32-bit, 64-bit and floating-point weights, each on
+// its default queue, then show what saturation does on a path too long for 32 bits
+void benchmarkWeightTypes(const CsrGraph& graph, int queries, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<int> sources(queries);
+    for (int& s : sources) {
+        s = static_cast<int>(rng() % graph.numVertices());
+    }
+
+    std::cout << "Graph: " << graph.numVertices() << " vertices, " << graph.numEdges() << " arcs, max weight "
+              << graph.maxWeight() << "; " << queries << " queries\n";
+    std::cout << std::left << std::setw(22) << "Weights" << std::right << std::setw(14) << "ms/query"
+              << std::setw(12) << "vs uint32" << std::setw(14) << "graph MB" << std::setw(10) << "Match" << "\n";
+
+    std::vector<std::vector<double>> reference;
+    double baseMs = 0;
+    auto run = [&](const char* label, const auto& typed) {
+        using W = typename std::decay<decltype(typed)>::type::weight_type;
+        DijkstraEngine<W> engine(typed);
+        bool match = true;
+        auto start = std::chrono::steady_clock::now();
+        for (int q = 0; q < queries; ++q) {
+            const BasicShortestPaths<W>& paths = engine.run(sources[q]);
+            std::vector<double> dist(paths.dist.begin(), paths.dist.end());
+            if (reference.size() < sources.size()) {
+                reference.push_back(dist);
+            } else {
+                match = match && dist == reference[q];
+            }
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / queries;
+        if (baseMs == 0) {
+            baseMs = ms;
+        }
+        double mb = (double(typed.numVertices() + 1) * sizeof(int) + double(typed.numEdges()) * (sizeof(int) + sizeof(W))) / 1e6;
+        std::cout << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << ms << std::setw(11) << baseMs / ms << "x" << std::setw(14) << mb
+                  << std::setw(10) << (match ? "yes" : "NO") << "\n";
+    };
+    run("uint32 (radix heap)", graph);
+    run("uint64 (radix heap)", withWeightType<uint64_t>(graph));
+    run("double (4-ary heap)", withWeightType<double>(graph));
+
+    // Two 3e9 edges: the 6e9 path overflows 32 bits and saturates to unreachable
+    std::vector<BasicEdge<uint32_t>> chain32 = {{0, 1, 3000000000u}, {1, 2, 3000000000u}};
+    std::vector<BasicEdge<uint64_t>> chain64 = {{0, 1, 3000000000u}, {1, 2, 3000000000u}};
+    BasicShortestPaths<uint32_t> narrow = dijkstra(BasicCsrGraph<uint32_t>::fromEdges(3, chain32, false), 0);
+    BasicShortestPaths<uint64_t> wide = dijkstra(BasicCsrGraph<uint64_t>::fromEdges(3, chain64, false), 0);
+    std::cout << "Path of two 3e9 edges: uint32 ";
+    if (narrow.dist[2] == infiniteWeight<uint32_t>()) {
+        std::cout << "INF (saturated)";
+    } else {
+        std::cout << narrow.dist[2];
+    }
+    std::cout << ", uint64 " << wide.dist[2] << "\n";
+}
+
+// Sequential Dijkstra against delta-stepping at 1, 2, 4, ... threads on the same
+// sources; every parallel run must reproduce the sequential distances exactly
+void benchmarkDeltaStepping(const CsrGraph& graph, int queries, int maxThreads, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<int> sources(queries);
+    for (int& s : sources) {
+        s = static_cast<int>(rng() % graph.numVertices());
+    }
+
+    std::cout << "Graph: " << graph.numVertices() << " vertices, " << graph.numEdges() << " arcs, max weight "
+              << graph.maxWeight() << "; " << queries << " queries\n";
+
+    // The baseline stays on the 4-ary heap so speedups are comparable with earlier runs
+    std::vector<std::vector<Weight>> reference;
+    DijkstraEngine<Weight, QuaternaryHeap> sequential(graph);
+    auto start = std::chrono::steady_clock::now();
+    for (int src : sources) {
+        reference.push_back(sequential.run(src).dist);
+    }
+    double sequentialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / queries;
+
+    std::cout << std::left << std::setw(22) << "Mode" << std::right << std::setw(14) << "ms/query"
+              << std::setw(12) << "Speedup" << std::setw(10) << "Match" << "\n";
+    std::cout << std::left << std::setw(22) << "Dijkstra (4-ary heap)" << std::right << std::fixed
+              << std::setprecision(2) << std::setw(14) << sequentialMs << std::setw(11) << 1.0 << "x"
+              << std::setw(10) << "-" << "\n";
+
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    for (int threads : threadCounts) {
+        ThreadPool pool(threads);
+        DeltaSteppingEngine engine(graph, pool);
+        bool match = true;
+        start = std::chrono::steady_clock::now();
+        for (int q = 0; q < queries; ++q) {
+            match = match && engine.run(sources[q]).dist == reference[q];
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / queries;
+        std::string label = "delta-step x" + std::to_string(threads);
+        std::cout << std::left << std::setw(22) << label << std::right << std::setw(14) << ms << std::setw(11)
+                  << sequentialMs / ms << "x" << std::setw(10) << (match ? "yes" : "NO") << "\n";
+    }
+
+    // A delta far below the weight range must stay within the capped bucket
+    // window: a 2e9 edge next to a 5 edge, and a small grid with weights up to 1e7
+    ThreadPool pool(maxThreads);
+    bool match = true;
+    auto check = [&](const CsrGraph& g) {
+        DijkstraEngine<Weight, QuaternaryHeap> exact(g);
+        for (Weight delta : {Weight(1), Weight(10)}) {
+            DeltaSteppingEngine engine(g, pool, delta);
+            for (int src : {0, g.numVertices() - 1}) {
+                match = match && engine.run(src).dist == exact.run(src).dist;
+            }
+        }
+    };
+    std::vector<Edge> chain = {{0, 1, 2000000000u}, {1, 2, 5}};
+    check(CsrGraph::fromEdges(3, chain, true));
+    check(makeGridGraph(32, 10000000, seed));
+    std::cout << "Small delta, large weights: match " << (match ? "yes" : "NO") << "\n";
+}
+
+// Road network with coordinates: a side x side grid of unit-spaced junctions
+// whose streets take 50-100 time units per unit length, every tenth row and
+// column an arterial road taking 15-25, plus side * side / 64 motorway links
+// taking 20-40. Weights are travel times, so the Euclidean heuristic has a
+// meaningful scale, and the faster roads give the network a hierarchy.
+CsrGraph makeRoadGraph(int side, unsigned seed, std::vector<Point>& coords) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> street(50, 100);
+    std::uniform_real_distribution<double> motorway(20, 40);
+    std::uniform_real_distribution<double> arterial(15, 25);
+    int V = side * side;
+    coords.resize(V);
+    std::vector<Edge> edges;
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int u = r * side + c;
+            coords[u] = {double(c), double(r)};
+            if (c + 1 < side) edges.push_back({u, u + 1, static_cast<Weight>(r % 10 == 0 ? arterial(rng) : street(rng))});
+            if (r + 1 < side) edges.push_back({u, u + side, static_cast<Weight>(c % 10 == 0 ? arterial(rng) : street(rng))});
+        }
+    }
+    std::uniform_int_distribution<int> offset(-side / 8, side / 8);
+    for (int i = 0; i < V / 64; ++i) {
+        int r = static_cast<int>(rng() % side);
+        int c = static_cast<int>(rng() % side);
+        int r2 = std::min(side - 1, std::max(0, r + offset(rng)));
+        int c2 = std::min(side - 1, std::max(0, c + offset(rng)));
+        double length = std::hypot(double(r2 - r), double(c2 - c));
+        edges.push_back({r * side + c, r2 * side + c2, static_cast<Weight>(std::ceil(length * motorway(rng)))});
+    }
+    return CsrGraph::fromEdges(V, edges, true);
+}
+
+// A source and target vertex for one point-to-point query
+struct StPair {
+    int source;
+    int target;
+};
+
+// Random s-t pairs answered by full Dijkstra, early exit, bidirectional and A*
+void benchmarkPointToPoint(int side, int queries, unsigned seed) {
+    std::vector<Point> coords;
+    CsrGraph graph = makeRoadGraph(side, 42, coords);
+    std::mt19937 rng(seed);
+    std::vector<StPair> pairs(queries);
+    for (StPair& st : pairs) {
+        st = {static_cast<int>(rng() % graph.numVertices()), static_cast<int>(rng() % graph.numVertices())};
+    }
+
+    DijkstraEngine<> engine(graph);
+    BidirectionalDijkstra bidirectional(graph, graph);
+    AStarEngine<EuclideanHeuristic> astar(graph, EuclideanHeuristic::fromGraph(graph, coords));
+
+    std::cout << "Graph: " << graph.numVertices() << " vertices, " << graph.numEdges() << " arcs; " << queries
+              << " s-t queries\n";
+    std::cout << std::left << std::setw(22) << "Mode" << std::right << std::setw(14) << "ms/query"
+              << std::setw(14) << "settled/query" << std::setw(10) << "Match" << "\n";
+
+    std::vector<Weight> reference;
+    auto time = [&](const char* name, auto&& query) {
+        bool match = true;
+        long long settled = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int q = 0; q < queries; ++q) {
+            PointToPoint answer = query(pairs[q].source, pairs[q].target);
+            settled += answer.settled;
+            if (reference.size() < pairs.size()) {
+                reference.push_back(answer.distance);
+            } else {
+                match = match && answer.distance == reference[q];
+            }
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / queries;
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << ms << std::setw(14) << settled / queries << std::setw(10)
+                  << (match ? "yes" : "NO") << "\n";
+    };
+
+    time("full Dijkstra", [&](int s, int t) {
+        PointToPoint answer;
+        answer.distance = engine.run(s).dist[t];
+        answer.settled = engine.settledCount();
+        return answer;
+    });
+    time("early exit", [&](int s, int t) { return shortestPath(engine, s, t); });
+    time("bidirectional", [&](int s, int t) { return bidirectional.query(s, t); });
+    time("A* (Euclidean)", [&](int s, int t) { return astar.query(s, t); });
+}
+
+// Build a hierarchy for the road grid, write it to indexPath, map it back in
+// and compare its s-t queries against bidirectional Dijkstra on the original graph
+void benchmarkContractionHierarchy(int side, int queries, const std::string& indexPath, unsigned seed) {
+    std::vector<Point> coords;
+    CsrGraph graph = makeRoadGraph(side, 42, coords);
+    std::cout << "Graph: " << graph.numVertices() << " vertices, " << graph.numEdges() << " arcs\n";
+
+    auto start = std::chrono::steady_clock::now();
+    ContractionHierarchy built = ContractionHierarchy::build(graph);
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    built.save(indexPath);
+    std::cout << "Built in " << std::fixed << std::setprecision(2) << buildSeconds << " s: " << built.numShortcuts()
+              << " shortcuts, " << built.numArcs() << " upward arcs\n";
+
+    start = std::chrono::steady_clock::now();
+    MappedContractionHierarchy index(indexPath);
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Mapped " << indexPath << " (" << index.fileBytes() / (1024 * 1024) << " MiB) in " << loadMs
+              << " ms\n";
+
+    std::mt19937 rng(seed);
+    std::vector<StPair> pairs(queries);
+    for (StPair& st : pairs) {
+        st = {static_cast<int>(rng() % graph.numVertices()), static_cast<int>(rng() % graph.numVertices())};
+    }
+
+    BidirectionalDijkstra bidirectional(graph, graph);
+    std::vector<Weight> reference;
+    start = std::chrono::steady_clock::now();
+    for (const StPair& st : pairs) {
+        reference.push_back(bidirectional.query(st.source, st.target).distance);
+    }
+    double dijkstraUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queries;
+
+    ChQueryEngine engine(index.view());
+    bool match = true;
+    start = std::chrono::steady_clock::now();
+    for (int q = 0; q < queries; ++q) {
+        match = match && engine.distance(pairs[q].source, pairs[q].target) == reference[q];
+    }
+    double distanceUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queries;
+
+    long long settled = 0;
+    start = std::chrono::steady_clock::now();
+    for (int q = 0; q < queries; ++q) {
+        PointToPoint answer = engine.query(pairs[q].source, pairs[q].target);
+        match = match && answer.distance == reference[q];
+        settled += answer.settled;
+    }
+    double pathUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / queries;
+
+    std::cout << "Bidirectional Dijkstra:     " << dijkstraUs << " us/query\n";
+    std::cout << "CH distance:                " << distanceUs << " us/query (" << dijkstraUs / distanceUs
+              << "x faster), " << settled / queries << " settled/query\n";
+    std::cout << "CH distance + path unpack:  " << pathUs << " us/query\n";
+    std::cout << "Distances match: " << (match ? "yes" : "NO") << "\n";
+}
+
+// COUNT random sources and targets on the road grid: the one-call-per-source
+// baseline against the many-to-many engine per thread count, then a single
+// multi-source run against the baseline's per-vertex minimum
+void benchmarkBatched(int side, int count, int maxThreads, unsigned seed) {
+    std::vector<Point> coords;
+    CsrGraph graph = makeRoadGraph(side, 42, coords);
+    std::mt19937 rng(seed);
+    std::vector<int> sources(count);
+    std::vector<int> targets(count);
+    for (int i = 0; i < count; ++i) {
+        sources[i] = static_cast<int>(rng() % graph.numVertices());
+        targets[i] = static_cast<int>(rng() % graph.numVertices());
+    }
+    std::cout << "Graph: " << graph.numVertices() << " vertices, " << graph.numEdges() << " arcs; " << count
+              << " sources x " << count << " targets\n";
+
+    // Baseline: a fresh dijkstra() per source, also folded into nearest-source distances
+    std::vector<Weight> reference(static_cast<size_t>(count) * count);
+    std::vector<Weight> nearest(graph.numVertices(), INF);
+    auto start = std::chrono::steady_clock::now();
+    for (int row = 0; row < count; ++row) {
+        ShortestPaths paths = dijkstra(graph, sources[row]);
+        for (int col = 0; col < count; ++col) {
+            reference[static_cast<size_t>(row) * count + col] = paths.dist[targets[col]];
+        }
+        for (int v = 0; v < graph.numVertices(); ++v) {
+            nearest[v] = std::min(nearest[v], paths.dist[v]);
+        }
+    }
+    double baselineMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::left << std::setw(26) << "Mode" << std::right << std::setw(12) << "ms" << std::setw(12)
+              << "Speedup" << std::setw(10) << "Match" << "\n";
+    auto report = [&](const std::string& name, double ms, bool match) {
+        std::cout << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << ms << std::setw(11) << baselineMs / ms << "x" << std::setw(10)
+                  << (match ? "yes" : "NO") << "\n";
+    };
+    report("dijkstra() per source", baselineMs, true);
+
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+    for (int threads : threadCounts) {
+        ThreadPool pool(threads);
+        ManyToManyEngine engine(graph, pool);
+        start = std::chrono::steady_clock::now();
+        DistanceMatrix matrix = engine.compute(sources, targets);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        report("many-to-many x" + std::to_string(threads), ms, matrix.values == reference);
+    }
+
+    DijkstraEngine<> engine(graph);
+    start = std::chrono::steady_clock::now();
+    FacilityAssignment assignment = nearestFacilities(engine, sources);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    report("nearest source (1 run)", ms, assignment.dist == nearest);
+}
+
+// Traffic on a road grid: batches of random undirected edges get new weights,
+// and repairing the tree is timed against a full rerun on the updated graph
+void benchmarkDynamic(int side, int batches, unsigned seed) {
+    CsrGraph graph = makeGridGraph(side, 100, 42);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> vertex(0, graph.numVertices() - 1);
+    std::uniform_int_distribution<Weight> traffic(1, 200);
+    int source = vertex(rng);
+
+    std::cout << "Graph: " << graph.numVertices() << " vertices, " << graph.numEdges() << " arcs; source "
+              << source << ", " << batches << " batches per size\n";
+    std::cout << std::left << std::setw(14) << "Batch edges" << std::right << std::setw(14) << "repair ms"
+              << std::setw(14) << "repaired" << std::setw(14) << "full ms" << std::setw(12) << "speedup"
+              << std::setw(10) << "Match" << "\n";
+
+    DynamicShortestPaths dynamic(graph, source);
+    std::vector<Edge> current;
+    for (int size : {1, 10, 100, 1000}) {
+        double repairMs = 0;
+        double fullMs = 0;
+        long long repaired = 0;
+        bool match = true;
+        for (int b = 0; b < batches; ++b) {
+            std::vector<Edge> changes;
+            for (int i = 0; i < size; ++i) {
+                int u = vertex(rng);
+                int degree = graph.edgesEnd(u) - graph.edgesBegin(u);
+                if (degree == 0) {
+                    continue;
+                }
+                int v = graph.target(graph.edgesBegin(u) + static_cast<int>(rng() % degree));
+                Weight w = traffic(rng);
+                changes.push_back({u, v, w});
+                changes.push_back({v, u, w});
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            const ShortestPaths& paths = dynamic.update(changes);
+            repairMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            repaired += dynamic.repairedCount();
+
+            // Reference: rebuild the graph with the current weights and start over
+            current.clear();
+            for (int u = 0; u < graph.numVertices(); ++u) {
+                for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); ++e) {
+                    current.push_back({u, graph.target(e), dynamic.weight(e)});
+                }
+            }
+            CsrGraph updated = CsrGraph::fromEdges(graph.numVertices(), current, false);
+            DijkstraEngine<> engine(updated);
+            start = std::chrono::steady_clock::now();
+            const ShortestPaths& full = engine.run(source);
+            fullMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            match = match && full.dist == paths.dist;
+        }
+        std::cout << std::left << std::setw(14) << size << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(14) << repairMs / batches << std::setw(14) << repaired / batches << std::setw(14)
+                  << fullMs / batches << std::setprecision(1) << std::setw(11) << fullMs / repairMs << "x"
+                  << std::setw(10) << (match ? "yes" : "NO") << "\n";
+    }
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--queue lazy|dary|radix|dial] [--threads N]\n"
+              << "       [--bench-queues SIDE [QUERIES]] [--bench-delta SIDE [QUERIES]] [--bench-st SIDE [QUERIES]]\n"
+              << "       [--bench-ch SIDE [QUERIES]] [--ch-index PATH] [--bench-many SIDE [COUNT]]\n"
+              << "       [--bench-weights SIDE [QUERIES]] [--bench-dynamic SIDE [BATCHES]]\n";
+    std::cerr << "  --queue NAME          priority queue for the example query (default dary)\n";
+    std::cerr << "  --threads N           run the example with delta-stepping on N threads; also the\n"
+              << "                        largest thread count for --bench-delta and --bench-many\n"
+              << "                        (default: all cores)\n";
+    std::cerr << "  --bench-queues SIDE   compare all queues on a SIDE x SIDE grid road graph\n";
+    std::cerr << "  --bench-delta SIDE    delta-stepping speedup versus thread count on the same graph\n";
+    std::cerr << "  --bench-st SIDE       s-t queries: full, early exit, bidirectional and A* search\n";
+    std::cerr << "  --bench-ch SIDE       build, save and map a contraction hierarchy, then time its queries\n";
+    std::cerr << "  --ch-index PATH       index file written by --bench-ch (default road_grid.ch)\n";
+    std::cerr << "  --bench-many SIDE     COUNT x COUNT distance matrix and nearest-source batch queries\n";
+    std::cerr << "  --bench-weights SIDE  the same queries with uint32, uint64 and double weights\n";
+    std::cerr << "  --bench-dynamic SIDE  repair after batches of weight changes versus a full rerun\n";
+}
+
+// Main function to create a graph and run Dijkstra's algorithm
+int main(int argc, char* argv[]) {
+    QueueKind queue = QueueKind::Dary;
+    int threads = 0;
+    int benchSide = 2;
+    int benchQueries = 10;
+    std::string bench;
+    std::string indexPath = "road_grid.ch";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--queue" && i + 1 < argc && parseQueueKind(argv[i + 1], queue)) {
+            ++i;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--ch-index" && i + 1 < argc) {
+            indexPath = argv[++i];
+        } else if ((arg == "--bench-queues" || arg == "--bench-delta" || arg == "--bench-st" || arg == "--bench-ch" ||
+                    arg == "--bench-many" || arg == "--bench-weights" || arg == "--bench-dynamic") &&
+                   i + 1 < argc) {
+            bench = arg;
+            benchSide = std::max(2, std::atoi(argv[++i]));
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                benchQueries = std::max(1, std::atoi(argv[++i]));
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (bench == "--bench-dynamic") {
+        benchmarkDynamic(benchSide, benchQueries, 7);
+        return 0;
+    }
+    if (bench == "--bench-st") {
+        benchmarkPointToPoint(benchSide, benchQueries, 7);
+        return 0;
+    }
+    if (bench == "--bench-ch") {
+        try {
+            benchmarkContractionHierarchy(benchSide, benchQueries, indexPath, 7);
+        } catch (const std::runtime_error& e) {
+            std::cerr << "I/O Error: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    int maxThreads = threads > 0 ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    if (bench == "--bench-many") {
+        benchmarkBatched(benchSide, benchQueries, maxThreads, 7);
+        return 0;
+    }
+    if (!bench.empty()) {
+        CsrGraph grid = makeGridGraph(benchSide, 100, 42);
+        if (bench == "--bench-delta") {
+            benchmarkDeltaStepping(grid, benchQueries, maxThreads, 7);
+        } else if (bench == "--bench-weights") {
+            benchmarkWeightTypes(grid, benchQueries, 7);
+        } else {
+            benchmarkQueues(grid, benchQueries, 7);
+        }
+        return 0;
+    }
+
+    // Number of vertices in the graph
+    int V = 9;
+
+    // Edge list, converted to CSR once all edges are known
+    std::vector<Edge> edges;
+
+    // Function to add an edge to the graph
+    auto addEdge = [&](int u, int v, Weight w) {
+        edges.push_back({u, v, w});
+    };
+
+    // Creating the graph from the example
+    addEdge(0, 1, 4);
+    addEdge(0, 7, 8);
+    addEdge(1, 2, 8);
+    addEdge(1, 7, 11);
+    addEdge(2, 3, 7);
+    addEdge(2, 8, 2);
+    addEdge(2, 5, 4);
+    addEdge(3, 4, 9);
+    addEdge(3, 5, 14);
+    addEdge(4, 5, 10);
+    addEdge(5, 6, 2);
+    addEdge(6, 7, 1);
+    addEdge(6, 8, 6);
+    addEdge(7, 8, 7);
+
+    CsrGraph graph = CsrGraph::fromEdges(V, edges, true); // For an undirected graph
+
+    // Set the source vertex
+    int source = 0;
+
+    // The predecessor array gives the actual route, not just its length
+    auto report = [&](const ShortestPaths& paths) {
+        printDistances(paths, source);
+        int target = 4;
+        std::cout << "\nShortest path " << source << " -> " << target << ":";
+        for (int v : extractPath(paths, target)) {
+            std::cout << " " << v;
+        }
+        std::cout << "\n";
+    };
+
+    // Run Dijkstra's algorithm
+    if (threads > 0) {
+        report(deltaStepping(graph, source, threads));
+    } else {
+        withEngine(graph, queue, [&](auto& engine) { report(engine.run(source)); });
+    }
+
+    return 0;
+}
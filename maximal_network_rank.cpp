@@ -1,11 +1,111 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <unordered_set>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <chrono>
+#include <random>
+#include <queue>
 using namespace std;
 
+// Network rank of a pair of cities = degree(a) + degree(b), minus one if a road
+// joins them directly. Roads are distinct, as in the problem statement.
+//
+// Only two groups of cities can hold the best pair:
+// - If several cities share the top degree d1, the answer is 2 * d1 when two of
+//   them are not adjacent, else 2 * d1 - 1.
+// - If one city t has degree d1, the answer is d1 + d2 (d2 = second highest
+//   degree) when some city of degree d2 is not adjacent to t, else d1 + d2 - 1.
+// Only roads inside those groups go into the hashed road set, and the scan stops
+// at the first non-adjacent pair. Every adjacent pair it passes is a distinct
+// road, so it checks at most m + 1 pairs: O(n + m) expected time overall.
+class NetworkRankEngine {
+public:
+    NetworkRankEngine(int numCities, const vector<vector<int>>& roads) : degree(numCities, 0) {
+        for (const vector<int>& road : roads) {
+            degree[road[0]]++;
+            degree[road[1]]++;
+        }
+
+        // Top two distinct degrees and the cities holding them
+        for (int d : degree) {
+            if (d > first) {
+                second = first;
+                first = d;
+            } else if (d < first && d > second) {
+                second = d;
+            }
+        }
+        for (int city = 0; city < numCities; city++) {
+            if (degree[city] == first) {
+                top.push_back(city);
+            } else if (degree[city] == second) {
+                runnerUp.push_back(city);
+            }
+        }
+
+        // Hash only the roads that can decide the answer
+        for (const vector<int>& road : roads) {
+            int a = road[0], b = road[1];
+            bool candidate = top.size() >= 2
+                                 ? degree[a] == first && degree[b] == first
+                                 : (degree[a] == first && degree[b] == second) || (degree[a] == second && degree[b] == first);
+            if (candidate) {
+                roadSet.insert(key(a, b));
+            }
+        }
+    }
+
+    int maximalRank() const {
+        if (degree.size() < 2) {
+            return 0;
+        }
+
+        if (top.size() >= 2) {
+            for (size_t i = 0; i < top.size(); i++) {
+                for (size_t j = i + 1; j < top.size(); j++) {
+                    if (!connected(top[i], top[j])) {
+                        return 2 * first;
+                    }
+                }
+            }
+            return 2 * first - 1;
+        }
+
+        for (int city : runnerUp) {
+            if (!connected(top[0], city)) {
+                return first + second;
+            }
+        }
+        return first + second - 1;
+    }
+
+private:
+    static uint64_t key(int cityA, int cityB) {
+        if (cityA > cityB) {
+            swap(cityA, cityB);
+        }
+        return (uint64_t(cityA) << 32) | uint32_t(cityB);
+    }
+
+    bool connected(int cityA, int cityB) const { return roadSet.count(key(cityA, cityB)) > 0; }
+
+    vector<int> degree;
+    int first = -1, second = -1;      // highest and second-highest degree
+    vector<int> top, runnerUp;        // cities with those degrees
+    unordered_set<uint64_t> roadSet;  // candidate roads, smaller city in the high half
+};
+
 class Solution {
 public:
     int maximalNetworkRank(int numCities, vector<vector<int>>& roads) {
+        return NetworkRankEngine(numCities, roads).maximalRank();
+    }
+
+    // The original check of every city pair, O(n^2 * d); kept to verify the engine
+    int maximalNetworkRankAllPairs(int numCities, vector<vector<int>>& roads) {
         vector<int> degree(numCities, 0);
         vector<vector<int>> adjacency(numCities);
         int maxRank = 0;
@@ -35,7 +135,327 @@ public:
     }
 };
 
-int main() {
+// A pair of cities and its network rank
+struct RankedPair {
+    int cityA;
+    int cityB;
+    int rank;
+};
+
+// Network ranks over a road graph that changes one road at a time.
+// Cities sit in buckets by degree, and the non-empty degrees form a doubly linked
+// list from the highest down. A road changes two degrees by one, so a city only
+// moves to a neighbouring bucket and the list is patched in O(1): adding or
+// removing a road costs O(1) expected time and nothing is ever recomputed.
+//
+// topPairs(k) walks the list from the top and pops pairs of degree levels from
+// a small heap in decreasing order of degree sum s. Every city pair in a level
+// pair has rank s, or s - 1 if a road joins them, so it can stop as soon as k
+// pairs of rank >= s are in hand: no unseen pair can beat them. The cost is
+// O(k) pairs plus one per directly connected pair passed on the way (and a log
+// factor for the heap), independent of the number of cities.
+class NetworkRankService {
+public:
+    explicit NetworkRankService(int numCities)
+        : degree(numCities, 0), slot(numCities), buckets(1), up(1, -1), down(1, -1) {
+        for (int city = 0; city < numCities; city++) {
+            slot[city] = city;
+            buckets[0].push_back(city);
+        }
+        highest = numCities > 0 ? 0 : -1;
+    }
+
+    int numCities() const { return degree.size(); }
+    int numRoads() const { return roadSet.size(); }
+    int degreeOf(int city) const { return degree[city]; }
+    bool connected(int cityA, int cityB) const { return roadSet.count(key(cityA, cityB)) > 0; }
+
+    // False (and no change) for a self-loop, a city out of range or an existing road
+    bool addRoad(int cityA, int cityB) {
+        if (!valid(cityA, cityB) || !roadSet.insert(key(cityA, cityB)).second) {
+            return false;
+        }
+        raise(cityA);
+        raise(cityB);
+        return true;
+    }
+
+    // False (and no change) if there is no such road
+    bool removeRoad(int cityA, int cityB) {
+        if (!valid(cityA, cityB) || roadSet.erase(key(cityA, cityB)) == 0) {
+            return false;
+        }
+        lower(cityA);
+        lower(cityB);
+        return true;
+    }
+
+    int rank(int cityA, int cityB) const {
+        return degree[cityA] + degree[cityB] - (connected(cityA, cityB) ? 1 : 0);
+    }
+
+    int maximalRank() const {
+        vector<RankedPair> best = topPairs(1);
+        return best.empty() ? 0 : best[0].rank;
+    }
+
+    // The k highest-ranked city pairs, best first (ties in no particular order)
+    vector<RankedPair> topPairs(int k) const {
+        vector<RankedPair> found;
+        if (k <= 0 || numCities() < 2) {
+            return found;
+        }
+
+        // levels[i] is the i-th highest non-empty degree, filled in as the heap reaches it
+        vector<int> levels(1, highest);
+        auto level = [&](int i) {
+            while ((int)levels.size() <= i && down[levels.back()] != -1) {
+                levels.push_back(down[levels.back()]);
+            }
+            return i < (int)levels.size() ? levels[i] : -1;
+        };
+
+        // Level pairs (i, j), i <= j, keyed by degree sum: from (i, j) come
+        // (i, j + 1) and, on the diagonal, (i + 1, i + 1)
+        auto sumOf = [&](const pair<int, int>& p) { return levels[p.first] + levels[p.second]; };
+        auto smallerSum = [&](const pair<int, int>& a, const pair<int, int>& b) { return sumOf(a) < sumOf(b); };
+        priority_queue<pair<int, int>, vector<pair<int, int>>, decltype(smallerSum)> heap(smallerSum);
+        heap.push({0, 0});
+
+        int definite = 0;  // pairs found with rank >= the current sum
+        int pending = 0;   // connected pairs found at the current sum, rank one below it
+        int sum = 2 * highest;
+        while (!heap.empty()) {
+            pair<int, int> p = heap.top();
+            if (sumOf(p) < sum) {
+                sum = sumOf(p);
+                definite += pending;
+                pending = 0;
+            }
+            if (definite >= k) {
+                break;
+            }
+            heap.pop();
+            if (level(p.second + 1) != -1) {
+                heap.push({p.first, p.second + 1});
+            }
+            if (p.first == p.second && level(p.first + 1) != -1) {
+                heap.push({p.first + 1, p.first + 1});
+            }
+
+            const vector<int>& groupA = buckets[levels[p.first]];
+            const vector<int>& groupB = buckets[levels[p.second]];
+            for (size_t a = 0; a < groupA.size() && definite < k; a++) {
+                for (size_t b = p.first == p.second ? a + 1 : 0; b < groupB.size() && definite < k; b++) {
+                    bool joined = connected(groupA[a], groupB[b]);
+                    found.push_back({groupA[a], groupB[b], sum - (joined ? 1 : 0)});
+                    if (joined) {
+                        pending++;
+                    } else {
+                        definite++;
+                    }
+                }
+            }
+        }
+
+        stable_sort(found.begin(), found.end(), [](const RankedPair& a, const RankedPair& b) { return a.rank > b.rank; });
+        if ((int)found.size() > k) {
+            found.resize(k);
+        }
+        return found;
+    }
+
+private:
+    static uint64_t key(int cityA, int cityB) {
+        if (cityA > cityB) {
+            swap(cityA, cityB);
+        }
+        return (uint64_t(cityA) << 32) | uint32_t(cityB);
+    }
+
+    bool valid(int cityA, int cityB) const {
+        return cityA != cityB && cityA >= 0 && cityB >= 0 && cityA < numCities() && cityB < numCities();
+    }
+
+    // Move city from bucket d to bucket d + 1
+    void raise(int city) {
+        int d = degree[city];
+        if (d + 1 == (int)buckets.size()) {
+            buckets.emplace_back();
+            up.push_back(-1);
+            down.push_back(-1);
+        }
+        if (buckets[d + 1].empty()) {
+            // Level d is non-empty (city is in it), so d + 1 goes right above it
+            link(d + 1, up[d], d);
+        }
+        take(city);
+        degree[city] = d + 1;
+        put(city);
+    }
+
+    // Move city from bucket d to bucket d - 1
+    void lower(int city) {
+        int d = degree[city];
+        if (buckets[d - 1].empty()) {
+            link(d - 1, d, down[d]);
+        }
+        take(city);
+        degree[city] = d - 1;
+        put(city);
+    }
+
+    // Remove city from its bucket by swapping it with the last one
+    void take(int city) {
+        vector<int>& bucket = buckets[degree[city]];
+        int last = bucket.back();
+        bucket[slot[city]] = last;
+        slot[last] = slot[city];
+        bucket.pop_back();
+        if (bucket.empty()) {
+            unlink(degree[city]);
+        }
+    }
+
+    void put(int city) {
+        vector<int>& bucket = buckets[degree[city]];
+        slot[city] = bucket.size();
+        bucket.push_back(city);
+    }
+
+    // Insert level d between above and below (either may be -1)
+    void link(int d, int above, int below) {
+        up[d] = above;
+        down[d] = below;
+        if (above != -1) {
+            down[above] = d;
+        } else {
+            highest = d;
+        }
+        if (below != -1) {
+            up[below] = d;
+        }
+    }
+
+    void unlink(int d) {
+        if (up[d] != -1) {
+            down[up[d]] = down[d];
+        } else {
+            highest = down[d];
+        }
+        if (down[d] != -1) {
+            up[down[d]] = up[d];
+        }
+    }
+
+    vector<int> degree;
+    vector<int> slot;              // index of each city inside its bucket
+    vector<vector<int>> buckets;   // cities by degree
+    vector<int> up, down;          // neighbouring non-empty degrees, or -1
+    int highest;                   // largest non-empty degree
+    unordered_set<uint64_t> roadSet;
+};
+
+// Random distinct roads between numCities cities
+vector<vector<int>> randomRoads(int numCities, int numRoads, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> city(0, numCities - 1);
+    unordered_set<uint64_t> seen;
+    vector<vector<int>> roads;
+    while ((int)roads.size() < numRoads) {
+        int a = city(rng), b = city(rng);
+        if (a == b || !seen.insert((uint64_t(min(a, b)) << 32) | uint32_t(max(a, b))).second) {
+            continue;
+        }
+        roads.push_back({a, b});
+    }
+    return roads;
+}
+
+void benchmark(int numCities, int numRoads) {
+    Solution solution;
+    vector<vector<int>> roads = randomRoads(numCities, numRoads, 42);
+
+    auto start = chrono::steady_clock::now();
+    int rank = solution.maximalNetworkRank(numCities, roads);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << numCities << " cities, " << numRoads << " roads: rank " << rank << " in " << ms << " ms\n";
+
+    // The quadratic check is only practical on small inputs
+    if (numCities <= 20000) {
+        start = chrono::steady_clock::now();
+        int expected = solution.maximalNetworkRankAllPairs(numCities, roads);
+        ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << "All pairs: rank " << expected << " in " << ms << " ms (" << (rank == expected ? "match" : "MISMATCH")
+             << ")\n";
+    }
+}
+
+// A stream of random road additions and removals, querying the top k pairs
+// after every change; the final maximal rank is checked against a fresh engine
+void benchmarkStream(int numCities, int operations, int k) {
+    NetworkRankService service(numCities);
+    mt19937 rng(7);
+    uniform_int_distribution<int> city(0, numCities - 1);
+    vector<pair<int, int>> live;  // roads currently in the graph, for picking removals
+
+    double updateMs = 0, queryMs = 0;
+    long long checksum = 0;
+    for (int op = 0; op < operations; op++) {
+        auto start = chrono::steady_clock::now();
+        if (!live.empty() && rng() % 4 == 0) {
+            size_t i = rng() % live.size();
+            service.removeRoad(live[i].first, live[i].second);
+            live[i] = live.back();
+            live.pop_back();
+        } else {
+            int a = city(rng), b = city(rng);
+            if (service.addRoad(a, b)) {
+                live.push_back({a, b});
+            }
+        }
+        auto middle = chrono::steady_clock::now();
+        vector<RankedPair> best = service.topPairs(k);
+        auto end = chrono::steady_clock::now();
+        updateMs += chrono::duration<double, milli>(middle - start).count();
+        queryMs += chrono::duration<double, milli>(end - middle).count();
+        checksum += best.empty() ? 0 : best[0].rank;
+    }
+
+    vector<vector<int>> roads;
+    for (const pair<int, int>& road : live) {
+        roads.push_back({road.first, road.second});
+    }
+    int expected = NetworkRankEngine(numCities, roads).maximalRank();
+    cout << numCities << " cities, " << operations << " updates, " << service.numRoads() << " roads at the end\n";
+    cout << "Update: " << updateMs * 1000 / operations << " us, top " << k << " query: " << queryMs * 1000 / operations
+         << " us (checksum " << checksum << ")\n";
+    cout << "Final maximal rank " << service.maximalRank() << " ("
+         << (service.maximalRank() == expected ? "match" : "MISMATCH") << ")\n";
+    vector<RankedPair> best = service.topPairs(k);
+    for (const RankedPair& p : best) {
+        cout << "  " << p.cityA << " - " << p.cityB << ": " << p.rank << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        string mode = argv[1];
+        if (mode == "--bench-stream" && (argc == 4 || argc == 5)) {
+            benchmarkStream(max(2, atoi(argv[2])), max(1, atoi(argv[3])), argc == 5 ? max(1, atoi(argv[4])) : 10);
+            return 0;
+        }
+        if (mode != "--bench" || argc != 4) {
+            cerr << "Usage: " << argv[0] << " [--bench CITIES ROADS]\n"
+                 << "       " << argv[0] << " [--bench-stream CITIES UPDATES [K]]\n";
+            return 1;
+        }
+        int numCities = max(2, atoi(argv[2]));
+        long long limit = (long long)numCities * (numCities - 1) / 2;
+        benchmark(numCities, (int)min<long long>(max(0, atoi(argv[3])), limit));
+        return 0;
+    }
+
     Solution solution;
 
     int numCities = 4;